@@ -15,10 +15,30 @@
  *
  */
 
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <iomanip>
 #include <limits>
+#include <memory>
+#include <string>
 
+#include "include/AnalysisCluster.hpp"
+#include "include/Bench.hpp"
 #include "include/BoardHelper.hpp"
+#include "include/CpuDispatch.hpp"
+#include "include/DataGenerator.hpp"
+#include "include/EndgameBench.hpp"
+#include "include/GameRecord.hpp"
+#include "include/GameReview.hpp"
+#include "include/GameServer.hpp"
+#include "include/Match.hpp"
+#include "include/MctsSolver.hpp"
+#include "include/Profiler.hpp"
+#include "include/NnueNetwork.hpp"
 #include "include/Solver.hpp"
+#include "include/TraceReport.hpp"
 
 constexpr size_t MIN_MAX_DEPTH = 6; // Level of the game
 constexpr char PLAYER_X = 'X';
@@ -84,11 +104,353 @@ Position readUserMove() {
     return move;
 }
 
+void displayUsage(const char *program) {
+    std::cerr << "Usage :" << std::endl;
+    std::cerr << program << " [" << PLAYER_X << "|" << PLAYER_O << "] [--engine alphabeta|mcts] [--time-ms N] [--threads N]"
+              << " [--weights file.nnue] [--eval-cache-mb N] [--clock-ms N] [--inc-ms N] [--store file] [--store-mb N]"
+              << " [--lmr] [--futility] [--mtdf] [--trace file]" << std::endl;
+    std::cerr << program << " server <socket> [--workers N] [--tt-mb N] [--depth N]" << std::endl;
+    std::cerr << program << " loadtest <socket> [--sessions N] [--games N]" << std::endl;
+    std::cerr << program << " review <games> [--depth N] [--exact N] [--threads N] [--tt-mb N] [--store file]"
+              << " [--trace file]" << std::endl;
+    std::cerr << program << " analyze <positions> [--workers N] [--depth N] [--tt-mb N] [--socket path]"
+              << " [--job-timeout-ms N]" << std::endl;
+    std::cerr << program << " convert <games.txt> <games.rec>" << std::endl;
+    std::cerr << program << " nnue_random <out.nnue> [--seed N]" << std::endl;
+    std::cerr << program << " datagen <out.bin> [--games N] [--threads N] [--random N] [--play-depth N]"
+              << " [--depth N] [--exact N] [--samples N] [--seed N] [--dedup-capacity N]" << std::endl;
+    std::cerr << program << " bench [--depth N] [--mtdf] [--eval-cache-mb N] [--trace file] [--profile table|collapsed]" << std::endl;
+    std::cerr << program << " endgame_bench [positions.obf [--number-from N]] [--threads N] [--tt-mb N] [--first N] [--last N]"
+              << std::endl;
+    std::cerr << program << " eval_bench [--positions N] [--threads N]" << std::endl;
+    std::cerr << program << " match [--openings N] [--time-ms N] [--depth N] [--random N] [--seed N] [--threads N]"
+              << " [--lmr] [--futility] [--ref-lmr] [--ref-futility]" << std::endl;
+    std::cerr << program << " trace_report <trace> [--top N]" << std::endl;
+    std::cerr << program << " cpu" << std::endl;
+}
+
+/**
+ * @brief Reads the value of a "--name value" option.
+ * @return The value, or fallback if the option is absent.
+ */
+long long readOption(int argc, char *argv[], const std::string &name, long long fallback) {
+    for (int i = 0; i + 1 < argc; i++)
+        if (argv[i] == name)
+            return std::stoll(argv[i + 1]);
+    return fallback;
+}
+
+std::string readOption(int argc, char *argv[], const std::string &name, const std::string &fallback) {
+    for (int i = 0; i + 1 < argc; i++)
+        if (argv[i] == name)
+            return argv[i + 1];
+    return fallback;
+}
+
+/**
+ * @brief Checks if a "--name" flag is given.
+ */
+bool hasFlag(int argc, char *argv[], const std::string &name) {
+    for (int i = 0; i < argc; i++)
+        if (argv[i] == name)
+            return true;
+    return false;
+}
+
+GameServer *runningServer = nullptr;
+
+void stopServer(int) {
+    if (runningServer)
+        runningServer->stop();
+}
+
+int runServer(int argc, char *argv[]) {
+    ServerOptions options;
+    options.socketPath = argv[2];
+    options.workers = static_cast<unsigned int>(readOption(argc, argv, "--workers", 0));
+    options.tableMegabytes = static_cast<std::size_t>(readOption(argc, argv, "--tt-mb", 4));
+    options.depth = static_cast<int>(readOption(argc, argv, "--depth", MIN_MAX_DEPTH));
+    GameServer server(options);
+    runningServer = &server;
+    std::signal(SIGINT, stopServer);
+    std::signal(SIGTERM, stopServer);
+    int status = server.run();
+    runningServer = nullptr;
+    return status;
+}
+
+/**
+ * @brief Reads games from a binary record file, or else from a text file of {row,col} moves.
+ */
+std::vector<std::vector<Position>> readGames(const std::string &path) {
+    std::vector<std::vector<Position>> games;
+    if (GameRecord::isRecordFile(path)) {
+        GameRecord::Reader reader(path);
+        reader.forEach([&games](const GameRecord::GameView &game) {
+            std::vector<Position> moves;
+            for (int i = 0; i < game.header.moveCount; i++)
+                moves.push_back(toPosition(game.moves[i]));
+            games.push_back(moves);
+        });
+        return games;
+    }
+    std::ifstream in(path);
+    if (!in)
+        throw std::runtime_error("cannot open file");
+    return GameReview::readGames(in);
+}
+
+int runAnalyze(int argc, char *argv[]) {
+    ClusterOptions options;
+    // the running binary wherever it was started from, argv[0] where there is no /proc
+    options.executable = std::ifstream("/proc/self/exe") ? "/proc/self/exe" : argv[0];
+    options.socketPath = readOption(argc, argv, "--socket", std::string());
+    options.workers = static_cast<unsigned int>(readOption(argc, argv, "--workers", 0));
+    options.depth = static_cast<int>(readOption(argc, argv, "--depth", options.depth));
+    options.tableMegabytes = static_cast<std::size_t>(readOption(argc, argv, "--tt-mb", options.tableMegabytes));
+    options.jobTimeoutMs = readOption(argc, argv, "--job-timeout-ms", 0);
+    std::ifstream in(argv[2]);
+    if (!in) {
+        std::cerr << argv[2] << ": cannot open" << std::endl;
+        return 1;
+    }
+    try {
+        std::vector<AnalysisCluster::Position> positions = AnalysisCluster::readPositions(in);
+        for (const ClusterResult &result: AnalysisCluster::runCoordinator(positions, options, std::cout))
+            if (!result.done)
+                return 1;
+    } catch (const std::exception &e) {
+        std::cerr << argv[2] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int runConvert(char *argv[]) {
+    try {
+        GameRecord::Writer writer(argv[3]);
+        for (const std::vector<Position> &game: readGames(argv[2])) {
+            std::vector<Square> moves;
+            for (const Position &move: game)
+                moves.push_back(toSquare(move));
+            writer.append(moves, GameRecord::finalResult(moves));
+        }
+        writer.flush();
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int runNnueRandom(int argc, char *argv[]) {
+    try {
+        NnueNetwork::writeRandom(argv[2], static_cast<std::uint64_t>(readOption(argc, argv, "--seed", 1)));
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Opens the analysis store given by "--store file [--store-mb N]".
+ * @return The store, nullptr if the option is absent.
+ * @throw std::runtime_error if the file cannot be opened.
+ */
+std::unique_ptr<AnalysisStore> openStore(int argc, char *argv[]) {
+    std::string path = readOption(argc, argv, "--store", std::string());
+    if (path.empty())
+        return nullptr;
+    return std::make_unique<AnalysisStore>(path, static_cast<std::size_t>(readOption(argc, argv, "--store-mb", 64)));
+}
+
+/**
+ * @brief Creates the search trace given by "--trace file".
+ * @return The trace, nullptr if the option is absent.
+ * @throw std::runtime_error if the file cannot be created.
+ */
+std::unique_ptr<SearchTrace> openTrace(int argc, char *argv[]) {
+    std::string path = readOption(argc, argv, "--trace", std::string());
+    if (path.empty())
+        return nullptr;
+    return std::make_unique<SearchTrace>(path);
+}
+
+int runReview(int argc, char *argv[]) {
+    ReviewOptions options;
+    options.depth = static_cast<int>(readOption(argc, argv, "--depth", MIN_MAX_DEPTH));
+    options.exactEmpties = static_cast<int>(readOption(argc, argv, "--exact", options.exactEmpties));
+    options.threads = static_cast<unsigned int>(readOption(argc, argv, "--threads", 0));
+    options.tableMegabytes = static_cast<std::size_t>(readOption(argc, argv, "--tt-mb", options.tableMegabytes));
+    std::vector<std::vector<Position>> games;
+    try {
+        games = readGames(argv[2]);
+    } catch (const std::exception &e) {
+        std::cerr << argv[2] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    std::unique_ptr<AnalysisStore> store;
+    std::unique_ptr<SearchTrace> trace;
+    try {
+        store = openStore(argc, argv);
+        trace = openTrace(argc, argv);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    options.store = store.get();
+    options.trace = trace.get();
+    return GameReview::reviewGames(games, options, std::cout) == 0 ? 0 : 1;
+}
+
+int runDataGen(int argc, char *argv[]) {
+    DataGenOptions options;
+    options.games = static_cast<int>(readOption(argc, argv, "--games", options.games));
+    options.threads = static_cast<unsigned int>(readOption(argc, argv, "--threads", 0));
+    options.randomPlies = static_cast<int>(readOption(argc, argv, "--random", options.randomPlies));
+    options.playDepth = static_cast<int>(readOption(argc, argv, "--play-depth", options.playDepth));
+    options.labelDepth = static_cast<int>(readOption(argc, argv, "--depth", options.labelDepth));
+    options.exactEmpties = static_cast<int>(readOption(argc, argv, "--exact", options.exactEmpties));
+    options.samplesPerGame = static_cast<int>(readOption(argc, argv, "--samples", options.samplesPerGame));
+    options.seed = static_cast<std::uint64_t>(readOption(argc, argv, "--seed", 1));
+    options.dedupCapacity = static_cast<std::size_t>(readOption(argc, argv, "--dedup-capacity", 0));
+    std::ofstream out(argv[2], std::ios::binary | std::ios::app);
+    if (!out) {
+        std::cerr << argv[2] << ": cannot open" << std::endl;
+        return 1;
+    }
+    DataGenerator::generate(options, out, std::cerr);
+    return out ? 0 : 1;
+}
+
+int runBench(int argc, char *argv[]) {
+    std::string profile = readOption(argc, argv, "--profile", std::string());
+    if (!profile.empty() && !Profiler::ENABLED) {
+        std::cerr << "profiling probes are compiled out, configure with -DOTHELLO_PROFILE=ON" << std::endl;
+        return 1;
+    }
+    std::unique_ptr<SearchTrace> trace;
+    try {
+        trace = openTrace(argc, argv);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    Profiler::reset();
+    std::cout << "kernels   : " << CpuDispatch::kernels().name << std::endl;
+    SearchOptions options;
+    options.mtdf = hasFlag(argc, argv, "--mtdf");
+    Bench::run(static_cast<int>(readOption(argc, argv, "--depth", Bench::DEFAULT_DEPTH)), std::cout, options,
+               trace.get(), static_cast<std::size_t>(readOption(argc, argv, "--eval-cache-mb", 0)));
+    if (profile == "table")
+        Profiler::printTable(std::cout);
+    else if (profile == "collapsed")
+        Profiler::printCollapsed(std::cout);
+    return 0;
+}
+
+int runEndgameBench(int argc, char *argv[]) {
+    EndgameBenchOptions options;
+    options.threads = static_cast<unsigned int>(readOption(argc, argv, "--threads", 1));
+    options.tableMegabytes = static_cast<std::size_t>(readOption(argc, argv, "--tt-mb", 64));
+    options.first = static_cast<int>(readOption(argc, argv, "--first", 0));
+    options.last = static_cast<int>(readOption(argc, argv, "--last", 0));
+    std::vector<EndgameBench::Position> positions;
+    if (argc >= 3 && argv[2][0] != '-') {
+        std::ifstream in(argv[2]);
+        if (!in) {
+            std::cerr << argv[2] << ": cannot open" << std::endl;
+            return 1;
+        }
+        try {
+            positions = EndgameBench::readPositions(in, static_cast<int>(readOption(argc, argv, "--number-from", 1)));
+        } catch (const std::exception &e) {
+            std::cerr << argv[2] << ": " << e.what() << std::endl;
+            return 1;
+        }
+    } else {
+        positions = EndgameBench::builtinPositions();
+    }
+    std::cout << "kernels   : " << CpuDispatch::kernels().name << std::endl;
+    return EndgameBench::run(positions, options, std::cout).failures == 0 ? 0 : 1;
+}
+
+int runTraceReport(int argc, char *argv[]) {
+    std::ifstream in(argv[2], std::ios::binary);
+    if (!in) {
+        std::cerr << argv[2] << ": cannot open" << std::endl;
+        return 1;
+    }
+    try {
+        TraceReport::run(in, std::cout, static_cast<int>(readOption(argc, argv, "--top", 20)));
+    } catch (const std::exception &e) {
+        std::cerr << argv[2] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int runMatch(int argc, char *argv[]) {
+    MatchOptions options;
+    options.openings = static_cast<int>(readOption(argc, argv, "--openings", options.openings));
+    options.threads = static_cast<unsigned int>(readOption(argc, argv, "--threads", 1));
+    options.randomPlies = static_cast<int>(readOption(argc, argv, "--random", options.randomPlies));
+    options.seed = static_cast<std::uint64_t>(readOption(argc, argv, "--seed", 1));
+    options.timeMs = static_cast<int>(readOption(argc, argv, "--time-ms", options.timeMs));
+    options.depth = static_cast<int>(readOption(argc, argv, "--depth", 0));
+    options.candidate.lateMoveReductions = hasFlag(argc, argv, "--lmr");
+    options.candidate.futilityPruning = hasFlag(argc, argv, "--futility");
+    options.reference.lateMoveReductions = hasFlag(argc, argv, "--ref-lmr");
+    options.reference.futilityPruning = hasFlag(argc, argv, "--ref-futility");
+    Match::run(options, std::cout);
+    return 0;
+}
+
 int main(int argc, char *argv[]) {
 
-    if (argc != 2 || ((argv[1][0] != PLAYER_X) && (argv[1][0] != PLAYER_O))) {
-        std::cerr << "Usage :" << std::endl;
-        std::cerr << argv[0] << " [" << PLAYER_X << "|" << PLAYER_O << "]" << std::endl;
+    std::string mode = argc >= 2 ? argv[1] : "";
+    if (mode == "server" && argc >= 3)
+        return runServer(argc, argv);
+    if (mode == "loadtest" && argc >= 3)
+        return GameServer::runLoadTest(argv[2], static_cast<int>(readOption(argc, argv, "--sessions", 16)),
+                                       static_cast<int>(readOption(argc, argv, "--games", 1)));
+    if (mode == "review" && argc >= 3)
+        return runReview(argc, argv);
+    if (mode == "analyze" && argc >= 3)
+        return runAnalyze(argc, argv);
+    if (mode == "worker" && argc >= 3)
+        return AnalysisCluster::runWorker(argv[2], static_cast<int>(readOption(argc, argv, "--depth", 8)),
+                                          static_cast<std::size_t>(readOption(argc, argv, "--tt-mb", 64)));
+    if (mode == "convert" && argc >= 4)
+        return runConvert(argv);
+    if (mode == "nnue_random" && argc >= 3)
+        return runNnueRandom(argc, argv);
+    if (mode == "datagen" && argc >= 3)
+        return runDataGen(argc, argv);
+    if (mode == "bench")
+        return runBench(argc, argv);
+    if (mode == "endgame_bench")
+        return runEndgameBench(argc, argv);
+    if (mode == "eval_bench") {
+        std::cout << "kernels   : " << CpuDispatch::kernels().name << std::endl;
+        return Bench::runEvaluation(static_cast<std::size_t>(readOption(argc, argv, "--positions", 200000)),
+                                    static_cast<unsigned int>(readOption(argc, argv, "--threads", 1)),
+                                    std::cout) == 0 ? 0 : 1;
+    }
+    if (mode == "match")
+        return runMatch(argc, argv);
+    if (mode == "trace_report" && argc >= 3)
+        return runTraceReport(argc, argv);
+    if (mode == "cpu") {
+        CpuDispatch::printReport(std::cout);
+        return 0;
+    }
+
+    std::string engine = readOption(argc, argv, "--engine", std::string("alphabeta"));
+    if (argc < 2 || ((argv[1][0] != PLAYER_X) && (argv[1][0] != PLAYER_O)) ||
+        (engine != "alphabeta" && engine != "mcts")) {
+        displayUsage(argv[0]);
         return 0;
     }
 
@@ -96,12 +458,72 @@ int main(int argc, char *argv[]) {
     char aiPlayer = (humanPlayer == PLAYER_X) ? PLAYER_O : PLAYER_X;
     char currentPlayer = PLAYER_X;
 
+    // neural network evaluation of the alpha-beta leaves, only loaded when given
+    std::unique_ptr<NnueNetwork> network;
+    std::string weights = readOption(argc, argv, "--weights", std::string());
+    if (!weights.empty()) {
+        try {
+            network = std::make_unique<NnueNetwork>(weights);
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "Network evaluation (" << NnueNetwork::kernelName() << " kernels)" << std::endl;
+    }
+    std::unique_ptr<AnalysisStore> store;
+    std::unique_ptr<SearchTrace> trace;
+    try {
+        store = openStore(argc, argv);
+        trace = openTrace(argc, argv);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
     displayStart();
 
     std::vector<std::vector<char>> board;
     BoardHelper::initBoard(board);
     Position move;
 
+    // kept for the whole game, so each AI move reuses the results of the previous ones
+    TranspositionTable table;
+    SearchContext context;
+    std::unique_ptr<EvalCache> evalCache;
+    if (long long megabytes = readOption(argc, argv, "--eval-cache-mb", 4); megabytes > 0)
+        evalCache = std::make_unique<EvalCache>(static_cast<std::size_t>(megabytes));
+    Solver solver(context, &table, network.get(), evalCache.get(), store.get());
+    SearchOptions searchOptions;
+    searchOptions.lateMoveReductions = hasFlag(argc, argv, "--lmr");
+    searchOptions.futilityPruning = hasFlag(argc, argv, "--futility");
+    searchOptions.mtdf = hasFlag(argc, argv, "--mtdf");
+    solver.setOptions(searchOptions);
+    std::unique_ptr<SearchTrace::Writer> traceWriter;
+    if (trace) {
+        traceWriter = std::make_unique<SearchTrace::Writer>(*trace);
+        solver.setTrace(traceWriter.get());
+    }
+
+    // Monte Carlo tree search, only built when selected
+    std::unique_ptr<ThreadPool> mctsPool;
+    std::unique_ptr<MctsSolver> mctsSolver;
+    std::chrono::milliseconds mctsBudget(readOption(argc, argv, "--time-ms", 1000));
+    if (engine == "mcts") {
+        auto threads = static_cast<unsigned int>(readOption(argc, argv, "--threads", 1));
+        if (threads > 1)
+            mctsPool = std::make_unique<ThreadPool>(threads);
+        mctsSolver = std::make_unique<MctsSolver>(mctsPool.get());
+    }
+
+    // game clock of the AI, only kept when a time control is given
+    std::unique_ptr<TimeManager> timeManager;
+    if (long long clock = readOption(argc, argv, "--clock-ms", 0); clock > 0) {
+        TimeControl control;
+        control.total = std::chrono::milliseconds(clock);
+        control.increment = std::chrono::milliseconds(readOption(argc, argv, "--inc-ms", 0));
+        timeManager = std::make_unique<TimeManager>(control);
+    }
+
     if (currentPlayer == humanPlayer)
         BoardHelper::printBoard(board);
 
@@ -111,7 +533,33 @@ int main(int argc, char *argv[]) {
                 std::cout << "\nYour move, Player " << humanPlayer << " (format: {row, col}): ";
                 move = readUserMove();
             } else {
-                move = Solver::getBestMovePosition(board, aiPlayer, MIN_MAX_DEPTH);
+                if (timeManager) {
+                    timeManager->startMove(64 - BoardHelper::countPiecesTotal(board));
+                    mctsBudget = timeManager->getSoftBudget();
+                }
+                if (mctsSolver) {
+                    MctsResult result = mctsSolver->search(board, aiPlayer, mctsBudget);
+                    move = toPosition(result.bestMove);
+                    std::cout << "\nMCTS: " << result.playouts << " playouts, "
+                              << static_cast<long long>(result.playouts / std::max(result.seconds, 1e-9))
+                              << " playouts/s, " << result.nodes << " nodes, win rate " << result.winRate;
+                } else {
+                    const std::uint64_t probesBefore = solver.getEvalCacheProbes();
+                    const std::uint64_t hitsBefore = solver.getEvalCacheHits();
+                    if (timeManager)
+                        move = solver.searchTimed(board, aiPlayer, *timeManager);
+                    else
+                        move = solver.search(board, aiPlayer, MIN_MAX_DEPTH);
+                    if (const std::uint64_t probes = solver.getEvalCacheProbes() - probesBefore; probes > 0)
+                        std::cout << "\nEval cache: " << std::fixed << std::setprecision(1)
+                                  << 100.0 * static_cast<double>(solver.getEvalCacheHits() - hitsBefore) /
+                                             static_cast<double>(probes)
+                                  << "% hits of " << probes << " lookups" << std::defaultfloat;
+                }
+                if (timeManager) {
+                    timeManager->stopMove();
+                    std::cout << "\nAI clock: " << timeManager->getRemaining().count() << " ms left";
+                }
                 std::cout << "\nAI's move, Player " << aiPlayer << ": " << move << std::endl;
             }
             if (BoardHelper::isValidMove(board, move, currentPlayer)) {
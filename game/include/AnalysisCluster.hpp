@@ -0,0 +1,122 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "Move.hpp"
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Settings of a distributed analysis.
+ */
+struct ClusterOptions {
+    /** @brief Path of the Othello executable started as worker. */
+    std::string executable;
+    /** @brief Path of the Unix domain socket the workers connect to; empty for one in /tmp named after the process id. */
+    std::string socketPath;
+    /** @brief Number of worker processes, 0 for the number of hardware threads. */
+    unsigned int workers = 0;
+    /** @brief Search depth of every position. */
+    int depth = 8;
+    /** @brief Transposition table budget of each worker, kept over all its positions, in megabytes. */
+    std::size_t tableMegabytes = 64;
+    /** @brief Number of workers a position may crash before it is reported as failed. */
+    int maxAttempts = 2;
+    /** @brief A worker busy on one position for longer is killed and replaced, 0 for no limit. */
+    long long jobTimeoutMs = 0;
+};
+
+/**
+ * @brief Analysis of one position.
+ */
+struct ClusterResult {
+    /** @brief true once a worker returned the analysis, false if the position failed. */
+    bool done = false;
+    /** @brief Best move, NO_SQUARE if the player has to pass. */
+    Square move = NO_SQUARE;
+    /** @brief Score of the best move, from the point of view of the player to move; for a pass, the score
+     * of the position after it. */
+    int score = 0;
+    /** @brief Nodes searched by the worker. */
+    unsigned long long nodes = 0;
+    /** @brief Number of workers that took the position, crashed ones included. */
+    int attempts = 0;
+};
+
+/**
+ * @brief Analysis of a position file by several local worker processes.
+ *
+ * The coordinator listens on a Unix domain socket and starts the workers, which are the same
+ * executable run in worker mode; each worker keeps its own transposition table, so the memory of
+ * the analysis grows with the number of processes, and a crash only costs the position being
+ * searched. The coordinator and the workers talk with a line based text protocol:
+ *
+ *     hello <pid>                     worker, once connected
+ *     job <id> <squares> <player>     coordinator: analyze a position
+ *     result <id> <move> <score> <nodes>   worker: the move is a Square, 64 for a pass
+ *     quit                            coordinator: exit
+ *
+ * Work is handed out one position at a time, to whichever worker is idle. A worker that exits,
+ * closes its socket or exceeds the time limit is killed and replaced, and its position is given
+ * to another worker, until it has crashed maxAttempts workers. The results are printed in the
+ * order of the file as soon as all the positions before them are done.
+ */
+class AnalysisCluster {
+public:
+    /**
+     * @brief A position to analyze.
+     */
+    struct Position {
+        /** @brief The 64 squares row by row, EMPTY, PLAYER_X or PLAYER_O. */
+        std::string squares;
+        /** @brief The player to move. */
+        char player;
+    };
+
+    /**
+     * @brief Reads positions, one per line: the 64 squares row by row ('-' or '.' for an empty
+     * square), a space and the player to move; the rest of the line is ignored, so positions in
+     * the obf format of the endgame benchmark can be read. Empty lines are skipped.
+     * @param in The stream to read.
+     * @return The positions.
+     * @throws std::runtime_error if a line is invalid.
+     */
+    static std::vector<Position> readPositions(std::istream &in);
+
+    /**
+     * @brief Analyzes positions with worker processes and prints one line per position, in order.
+     * @param positions The positions.
+     * @param options The settings.
+     * @param out The stream to print to.
+     * @return The results, in the order of the positions.
+     * @throws std::runtime_error if the socket cannot be set up or no worker can be started.
+     */
+    static std::vector<ClusterResult> runCoordinator(const std::vector<Position> &positions,
+                                                     const ClusterOptions &options, std::ostream &out);
+
+    /**
+     * @brief Runs a worker: connects to the coordinator and analyzes positions until told to quit.
+     * @param socketPath Path of the socket of the coordinator.
+     * @param depth Search depth of every position.
+     * @param tableMegabytes Transposition table budget, in megabytes.
+     * @return 0 when told to quit, 1 if the coordinator is unreachable or lost.
+     */
+    static int runWorker(const std::string &socketPath, int depth, std::size_t tableMegabytes);
+};
\ No newline at end of file
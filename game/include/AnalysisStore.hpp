@@ -0,0 +1,129 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "Move.hpp"
+#include "TranspositionTable.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Persistent store of deep search results, in a memory-mapped file.
+ *
+ * The store keeps what the TranspositionTable keeps (score, depth, bound, best move) for the
+ * positions searched deep enough to be worth remembering, and outlives the process: the next run,
+ * or another engine process running at the same time on the same file, finds them again. The
+ * Solver looks positions up here when its own table misses.
+ *
+ * The file is a header followed by a fixed number of buckets of four slots, so its size is
+ * bounded. A slot is two 64-bit words, the data and the key xored with the data, read and written
+ * with relaxed atomics directly in the shared mapping: a slot torn by a concurrent write of
+ * another process fails the key check and reads as a miss, so processes share the file without
+ * locks. Each open of the file starts a new generation; when a bucket is full, a store evicts the
+ * slot with the shallowest depth after aging, where every generation since the slot was last
+ * stored or hit costs two plies, so positions that keep being reached stay and stale ones go.
+ *
+ * Only available on POSIX systems.
+ */
+class AnalysisStore {
+public:
+    /** @brief A stored search result. */
+    struct Entry {
+        /** @brief Score of the position, as returned by the search. */
+        int score = 0;
+        /** @brief Remaining depth the position was searched to. */
+        int depth = 0;
+        /** @brief Whether the score is exact, a lower bound or an upper bound. */
+        TranspositionTable::Bound bound = TranspositionTable::BOUND_NONE;
+        /** @brief Best move found, NO_SQUARE if none. */
+        Square bestMove = NO_SQUARE;
+    };
+
+    /**
+     * @brief Opens a store, creating the file if it does not exist.
+     * @param path The file.
+     * @param sizeInMegabytes Size of a new file; an existing file keeps its size. The bucket
+     * count is rounded down to a power of two.
+     * @throw std::runtime_error if the file cannot be opened or mapped, or is not a store.
+     */
+    explicit AnalysisStore(const std::string &path, std::size_t sizeInMegabytes = 64);
+
+    ~AnalysisStore();
+
+    AnalysisStore(const AnalysisStore &) = delete;
+    AnalysisStore &operator=(const AnalysisStore &) = delete;
+
+    /**
+     * @brief Looks up a position. A hit marks the slot as used in the current generation.
+     * @param key The hash of the position.
+     * @param entry Receives the result if the position is stored.
+     * @return true if the position is stored, false otherwise.
+     */
+    bool probe(std::uint64_t key, Entry &entry);
+
+    /**
+     * @brief Stores a search result. A stored position is only replaced by a result searched at
+     * least as deep.
+     * @param key The hash of the position.
+     * @param entry The result.
+     */
+    void store(std::uint64_t key, const Entry &entry);
+
+    /** @brief Returns the number of slots of the store. */
+    [[nodiscard]] std::size_t size() const { return (bucketMask + 1) * BUCKET_SIZE; }
+
+    /** @brief Returns the number of lookups by this process. */
+    [[nodiscard]] std::uint64_t getProbes() const { return probes.load(std::memory_order_relaxed); }
+
+    /** @brief Returns the number of successful lookups by this process. */
+    [[nodiscard]] std::uint64_t getHits() const { return hits.load(std::memory_order_relaxed); }
+
+    /** @brief Returns the number of results stored by this process. */
+    [[nodiscard]] std::uint64_t getStores() const { return stores.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t BUCKET_SIZE = 4;
+
+    /** @brief One slot: the key xored with the data, then the data; both 0 when empty. */
+    struct Slot {
+        std::atomic<std::uint64_t> check;
+        std::atomic<std::uint64_t> data;
+    };
+
+    /** @brief Start of the file. */
+    struct Header {
+        char magic[8];
+        std::uint64_t bucketCount;
+        std::atomic<std::uint64_t> generation;
+    };
+
+    int fd = -1;
+    void *mapping = nullptr;
+    std::size_t mappingSize = 0;
+    Slot *slots = nullptr;
+    std::size_t bucketMask = 0;
+    std::uint8_t generation = 0;
+
+    std::atomic<std::uint64_t> probes{0};
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> stores{0};
+
+    /** @brief Packs a result: score, depth, bound, best move and generation. */
+    std::uint64_t pack(const Entry &entry) const;
+};
\ No newline at end of file
@@ -0,0 +1,81 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "Solver.hpp"
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @brief Totals of a benchmark run.
+ */
+struct BenchResult {
+    /** @brief Nodes visited over all the positions. */
+    unsigned long long nodes = 0;
+    /** @brief Search time over all the positions, in seconds. */
+    double seconds = 0;
+    /** @brief Lookups and hits in the evaluation cache over all the positions, 0 without a cache. */
+    std::uint64_t evalCacheProbes = 0;
+    std::uint64_t evalCacheHits = 0;
+    /** @brief Checksum of the node count and best move of every position. */
+    std::uint64_t signature = 0;
+};
+
+/**
+ * @brief Fixed-depth search benchmark over a built-in set of positions.
+ *
+ * Every position is searched from an empty transposition table, so the node counts only depend on
+ * the position, the depth and the search itself. The signature combines them: a change that only
+ * makes the search faster keeps it, a change of search behavior (move ordering, pruning,
+ * evaluation) changes it.
+ */
+class Bench {
+public:
+    /** @brief Default search depth. */
+    static constexpr int DEFAULT_DEPTH = 6;
+
+    /**
+     * @brief Searches every position and prints one line per position, then the totals.
+     * @param depth The search depth.
+     * @param out The stream to print to.
+     * @param options The search settings. With MTD(f), the passes of the last iteration of every
+     * position are printed too.
+     * @param trace Trace recording every node of the searches, nullptr for none.
+     * @param evalCacheMegabytes Size of the evaluation cache, emptied before every position like
+     * the table; 0 to evaluate every leaf. The cache changes the time, not the nodes.
+     * @return The totals.
+     */
+    static BenchResult run(int depth, std::ostream &out, const SearchOptions &options = SearchOptions(),
+                           SearchTrace *trace = nullptr, std::size_t evalCacheMegabytes = 0);
+
+    /**
+     * @brief Evaluates positions from random games one at a time with Evaluator::getEvaluation,
+     * then all at once with Evaluator::getEvaluations, and prints the time of both and the number
+     * of positions whose scores differ.
+     * @param positions The number of positions.
+     * @param threads The threads of the batch evaluation, 1 to evaluate on the calling thread.
+     * @param out The stream to print to.
+     * @return The number of positions scored differently, 0 when both paths agree.
+     */
+    static std::size_t runEvaluation(std::size_t positions, unsigned int threads, std::ostream &out);
+
+    /**
+     * @brief Returns the number of built-in positions.
+     * @return The position count.
+     */
+    static int positionCount();
+};
\ No newline at end of file
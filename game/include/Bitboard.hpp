@@ -0,0 +1,193 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "CpuDispatch.hpp"
+#include "Move.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Compact board made of two 64-bit masks, one bit per square (bit index = Square).
+ *
+ * The board is stored from the point of view of the player to move: playing a move swaps the two
+ * masks. Move generation and flips work on whole masks at once, which makes it the representation
+ * of choice for the deep searches of the endgame.
+ */
+class Bitboard {
+public:
+    /** @brief Discs of the player to move. */
+    std::uint64_t player = 0;
+    /** @brief Discs of the opponent. */
+    std::uint64_t opponent = 0;
+
+    Bitboard() = default;
+
+    Bitboard(std::uint64_t player, std::uint64_t opponent) : player(player), opponent(opponent) {};
+
+    /**
+     * @brief Builds a bitboard from a 2D char board.
+     * @param board 2D char vector representing the board.
+     * @param player The player to move ('X' or 'O').
+     * @return The bitboard.
+     */
+    static Bitboard fromBoard(const std::vector<std::vector<char>> &board, char player);
+
+    /**
+     * @brief Writes the bitboard back to a 2D char board.
+     * @param board Receives the board, resized to 8x8 if needed.
+     * @param player The player to move ('X' or 'O').
+     */
+    void toBoard(std::vector<std::vector<char>> &board, char player) const;
+
+    /**
+     * @brief Returns the legal moves of the player to move.
+     * @return A mask of the squares where the player can play.
+     */
+    [[nodiscard]] std::uint64_t getMoves() const { return CpuDispatch::kernels().getMoves(player, opponent); }
+
+    /**
+     * @brief Returns the discs flipped by a move.
+     * @param square The square of the move.
+     * @return A mask of the flipped discs, 0 if the move is not legal.
+     */
+    [[nodiscard]] std::uint64_t getFlips(Square square) const {
+        return CpuDispatch::kernels().getFlips(player, opponent, square);
+    }
+
+    /**
+     * @brief Plays a move and gives the turn to the opponent.
+     * @param square The square of the move.
+     * @param flips The discs flipped by the move, as returned by getFlips.
+     */
+    void play(Square square, std::uint64_t flips) {
+        std::uint64_t newPlayer = opponent ^ flips;
+        opponent = player ^ flips ^ (1ULL << square);
+        player = newPlayer;
+    }
+
+    /** @brief Gives the turn to the opponent without playing. */
+    void pass() {
+        std::uint64_t newPlayer = opponent;
+        opponent = player;
+        player = newPlayer;
+    }
+
+    /** @brief Returns the number of empty squares. */
+    [[nodiscard]] int countEmpties() const { return popCount(~(player | opponent)); }
+
+    /**
+     * @brief Returns the final score of the player to move, once the game is over. As in
+     * tournament play, the empty squares are counted for the winner.
+     * @return The disc difference, from the point of view of the player to move.
+     */
+    [[nodiscard]] int getFinalScore() const;
+
+    /** @brief Number of symmetries of the board: identity, mirrors and rotations. */
+    static constexpr int SYMMETRY_COUNT = 8;
+
+    /**
+     * @brief Applies one of the 8 symmetries of the board to a mask.
+     * @param mask The mask.
+     * @param symmetry The symmetry, in [0, SYMMETRY_COUNT): bit 0 mirrors the columns, bit 1
+     * mirrors the rows, bit 2 swaps rows and columns (applied in that order). 0 is the identity.
+     * @return The transformed mask.
+     */
+    static std::uint64_t transform(std::uint64_t mask, int symmetry);
+
+    /**
+     * @brief Applies one of the 8 symmetries of the board to both masks.
+     * @param symmetry The symmetry, as for transform.
+     * @return The transformed board.
+     */
+    [[nodiscard]] Bitboard transformed(int symmetry) const {
+        return {transform(player, symmetry), transform(opponent, symmetry)};
+    }
+
+    /**
+     * @brief Returns the representative of the class of boards equal to this one by symmetry:
+     * the smallest of the 8 transformed boards.
+     * @return The canonical board.
+     */
+    [[nodiscard]] Bitboard canonical() const;
+
+    /**
+     * @brief Returns the symmetry that gives the canonical board.
+     * @return The first symmetry s such that transformed(s) == canonical().
+     */
+    [[nodiscard]] int canonicalSymmetry() const;
+
+    /**
+     * @brief Returns the symmetries that leave the board unchanged, besides the identity.
+     * @return A mask with bit s set if transformed(s) == *this, 0 for a board without symmetry.
+     */
+    [[nodiscard]] unsigned symmetries() const;
+
+    /**
+     * @brief Returns the symmetry undoing another one.
+     * @param symmetry The symmetry, as for transform.
+     * @return The symmetry t such that transform(transform(mask, symmetry), t) == mask.
+     */
+    static int inverseSymmetry(int symmetry) {
+        // the mirrors commute and are their own inverse; undoing a transpose after a single
+        // mirror takes the other mirror, as transposing swaps rows and columns
+        constexpr int INVERSES[SYMMETRY_COUNT] = {0, 1, 2, 3, 4, 6, 5, 7};
+        return INVERSES[symmetry];
+    }
+
+    /**
+     * @brief Returns a 64-bit hash of the board.
+     * @return The hash, equal for equal boards only (up to collisions).
+     */
+    [[nodiscard]] std::uint64_t hash() const {
+        std::uint64_t h = player * 0x9E3779B97F4A7C15ULL ^ (opponent + 0x632BE59BD9B4E019ULL);
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+        return h ^ (h >> 31);
+    }
+
+    bool operator<(const Bitboard &other) const {
+        return player < other.player || (player == other.player && opponent < other.opponent);
+    }
+
+    bool operator==(const Bitboard &other) const { return player == other.player && opponent == other.opponent; }
+
+    /**
+     * @brief Counts the bits set in a mask.
+     * @param mask The mask.
+     * @return The number of bits set.
+     */
+    static int popCount(std::uint64_t mask) { return CpuDispatch::kernels().popCount(mask); }
+
+    /**
+     * @brief Returns the lowest square of a mask.
+     * @param mask The mask, which must not be empty.
+     * @return The square of the lowest bit set.
+     */
+    static Square firstSquare(std::uint64_t mask) {
+#if defined(__GNUC__)
+        return static_cast<Square>(__builtin_ctzll(mask));
+#else
+        Square square = 0;
+        while (!(mask & 1)) {
+            mask >>= 1;
+            square++;
+        }
+        return square;
+#endif
+    }
+};
\ No newline at end of file
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "Move.hpp"
 #include "Position.hpp"
 #include <iostream>
 #include <vector>
@@ -62,6 +63,15 @@ public:
      */
     static bool isValidMove(const std::vector<std::vector<char>> &board, const Position &pos, char player);
 
+    /**
+     * @brief Checks if a move is valid for the current player.
+     * @param board 2D char vector representing the current state of the board.
+     * @param square The square at which the player wishes to make a move.
+     * @param player The character representing the current player.
+     * @return true if the move is valid, false otherwise.
+     */
+    static bool isValidMove(const std::vector<std::vector<char>> &board, Square square, char player);
+
     /**
      * @brief Reverses the opponent's pieces according to Othello rules after a valid move.
      * @param board 2D char vector representing the current state of the board. It will be updated
@@ -81,6 +91,23 @@ public:
      */
     static void playMove(std::vector<std::vector<char>> &board, const Position &pos, char player);
 
+    /**
+     * @brief Plays a move in place and records what it changed, so that undoMove can take it back.
+     * @param board 2D char vector representing the current state of the board. It will be updated
+     * with the new board state after reversing pieces.
+     * @param square The square at which the player places a piece. The move must be valid.
+     * @param player The character representing the current player.
+     * @param undo Filled with the played square and the reversed pieces.
+     */
+    static void playMove(std::vector<std::vector<char>> &board, Square square, char player, MoveUndo &undo);
+
+    /**
+     * @brief Takes back a move played with playMove.
+     * @param board 2D char vector representing the board, as left by playMove.
+     * @param undo The record filled by playMove.
+     */
+    static void undoMove(std::vector<std::vector<char>> &board, const MoveUndo &undo);
+
     /**
      * @brief Returns all possible moves for the current player.
      * @param board 2D char vector representing the board.
@@ -89,6 +116,22 @@ public:
      */
     static std::vector<Position> getAllPossibleMoves(const std::vector<std::vector<char>> &board, char player);
 
+    /**
+     * @brief Collects all possible moves for the current player, without allocating.
+     * @param board 2D char vector representing the board.
+     * @param player The current player.
+     * @param moves Cleared, then filled with the possible moves in board order.
+     */
+    static void getAllPossibleMoves(const std::vector<std::vector<char>> &board, char player, MoveList &moves);
+
+    /**
+     * @brief Checks if the current player has at least one possible move.
+     * @param board 2D char vector representing the board.
+     * @param player The current player.
+     * @return true if the player can play, false otherwise.
+     */
+    static bool hasAnyMove(const std::vector<std::vector<char>> &board, char player);
+
     /**
      * @brief Checks if the game is finished.
      * @param board 2D char vector representing the board.
@@ -0,0 +1,89 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Fixed-capacity set of 64-bit keys, safe to use from any number of threads without locks.
+ *
+ * Keys live in an open addressing table of atomic slots, probed linearly. A key is claimed with a
+ * single compare-and-swap on an empty slot, so two threads inserting the same key always agree on
+ * which one inserted it first. Keys are never removed.
+ */
+class ConcurrentHashSet {
+public:
+    /**
+     * @brief Constructs a new Concurrent Hash Set.
+     * @param capacity Minimum number of keys, rounded up to a power of two.
+     */
+    explicit ConcurrentHashSet(std::size_t capacity);
+
+    ConcurrentHashSet(const ConcurrentHashSet &) = delete;
+    ConcurrentHashSet &operator=(const ConcurrentHashSet &) = delete;
+
+    /** @brief Outcome of an insertion. */
+    enum InsertResult {
+        /** @brief The key was not in the set and now is. */
+        INSERTED,
+        /** @brief The key was already in the set. */
+        PRESENT,
+        /** @brief The key was not found but there was no free slot left for it. */
+        FULL
+    };
+
+    /**
+     * @brief Inserts a key.
+     * @param key The key, any value.
+     * @return INSERTED, PRESENT, or FULL if the key could not be stored: it may or may not have
+     * been inserted before.
+     */
+    InsertResult insert(std::uint64_t key);
+
+    /**
+     * @brief Checks if a key is in the set.
+     * @param key The key.
+     * @return true if the key has been inserted.
+     */
+    [[nodiscard]] bool contains(std::uint64_t key) const;
+
+    /**
+     * @brief Returns the number of keys in the set.
+     * @return The key count.
+     */
+    [[nodiscard]] std::size_t size() const { return count.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the number of slots of the set.
+     * @return The capacity.
+     */
+    [[nodiscard]] std::size_t capacity() const { return mask + 1; }
+
+private:
+    /** @brief Marks a free slot. The key 0 itself is kept apart, in zeroInserted. */
+    static constexpr std::uint64_t EMPTY_SLOT = 0;
+    /** @brief Maximum number of slots probed before the set is considered full. */
+    static constexpr std::size_t MAX_PROBES = 64;
+
+    std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+    std::size_t mask;
+    std::atomic<std::size_t> count{0};
+    std::atomic<bool> zeroInserted{false};
+};
\ No newline at end of file
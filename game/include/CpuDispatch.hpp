@@ -0,0 +1,99 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "Move.hpp"
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @brief Selection, at startup, of the fastest build of the hot kernels the CPU can run.
+ *
+ * The bitboard kernels (move generation, flips, disc counting), the batch evaluation and the
+ * neural network kernels are compiled several times, each time for a different instruction set:
+ * baseline x86-64, POPCNT, BMI2 (flips through PEXT/PDEP), AVX2 and AVX-512. At startup the CPU is
+ * queried with cpuid and the most advanced variant it supports becomes active, so one binary runs
+ * everywhere and uses what each machine has. Only the baseline variant is built for other
+ * compilers and architectures.
+ *
+ * The OTHELLO_ISA environment variable (baseline, popcnt, bmi2, avx2 or avx512) caps the choice,
+ * e.g. to compare the variants on one machine.
+ */
+namespace CpuDispatch {
+
+/** @brief Instruction set levels, each one including the previous ones. */
+enum Isa : int { ISA_BASELINE, ISA_POPCNT, ISA_BMI2, ISA_AVX2, ISA_AVX512, ISA_COUNT };
+
+/** @brief One build of the kernels. */
+struct Kernels {
+    /** @brief Instruction set the kernels were built for. */
+    Isa isa;
+    /** @brief Name of the instruction set. */
+    const char *name;
+    /** @brief Counts the bits set in a mask. */
+    int (*popCount)(std::uint64_t mask);
+    /** @brief Returns the legal moves of player against opponent. */
+    std::uint64_t (*getMoves)(std::uint64_t player, std::uint64_t opponent);
+    /** @brief Returns the discs flipped by player playing on square, 0 if the move is illegal. */
+    std::uint64_t (*getFlips)(std::uint64_t player, std::uint64_t opponent, Square square);
+    /** @brief Dot product of 8-bit activations in [0, 127] and 8-bit weights; size is a multiple of 32. */
+    std::int32_t (*dotProduct)(const std::uint8_t *input, const std::int8_t *weights, int size);
+    /** @brief Adds (sign 1) or subtracts (sign -1) a row of 16-bit weights, size a multiple of 32. */
+    void (*addRow)(std::int16_t *accumulator, const std::int16_t *row, int size, int sign);
+    /** @brief Clips 16-bit values to [0, 127] into bytes; size is a multiple of 32. */
+    void (*clip)(const std::int16_t *values, std::uint8_t *out, int size);
+    /** @brief Scores count boards, given as arrays of player and opponent discs, as Evaluator::getEvaluation. */
+    void (*evaluateBatch)(const std::uint64_t *players, const std::uint64_t *opponents, int *scores, int count);
+};
+
+/** @brief The variant in use; set once at startup. */
+extern const Kernels *active;
+
+/**
+ * @brief Returns the kernels in use.
+ * @return The active variant.
+ */
+inline const Kernels &kernels() { return *active; }
+
+/**
+ * @brief Queries the CPU for the most advanced instruction set it supports among the built variants.
+ * @return The instruction set.
+ */
+Isa detect();
+
+/**
+ * @brief Returns the kernels of an instruction set.
+ * @param isa The instruction set.
+ * @return The kernels, nullptr if this variant is not built.
+ */
+const Kernels *variant(Isa isa);
+
+/**
+ * @brief Makes the best built variant not above an instruction set active. Not thread-safe: only
+ * call it while no search runs.
+ * @param isa The highest instruction set allowed; capped to the one of the CPU.
+ * @return The kernels now active.
+ */
+const Kernels &select(Isa isa);
+
+/**
+ * @brief Prints the CPU features, the built variants and the active one.
+ * @param out The stream to print to.
+ */
+void printReport(std::ostream &out);
+
+} // namespace CpuDispatch
\ No newline at end of file
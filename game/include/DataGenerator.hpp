@@ -0,0 +1,97 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "Bitboard.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief Settings of a training data generation run.
+ */
+struct DataGenOptions {
+    /** @brief Number of self-play games. */
+    int games = 1000;
+    /** @brief Number of games played in parallel, 0 for the number of hardware threads. */
+    unsigned int threads = 0;
+    /** @brief Number of uniformly random moves at the start of every game. */
+    int randomPlies = 8;
+    /** @brief Search depth used to choose the moves after the random opening. */
+    int playDepth = 2;
+    /** @brief Search depth used to label the midgame positions. */
+    int labelDepth = 6;
+    /** @brief Positions with at most this many empty squares are labeled with their exact score. */
+    int exactEmpties = 14;
+    /** @brief Maximum number of positions sampled from every game. */
+    int samplesPerGame = 8;
+    /** @brief Seed of the random openings; game i uses seed + i, so runs are reproducible. */
+    std::uint64_t seed = 1;
+    /**
+     * @brief Capacity of the set of positions already written, used to drop duplicates. 0 sizes it
+     * for games * samplesPerGame positions, the most a run can write, so it never fills up.
+     */
+    std::size_t dedupCapacity = 0;
+    /** @brief Transposition table budget of each labeling search, in megabytes. */
+    std::size_t tableMegabytes = 4;
+};
+
+/**
+ * @brief Self-play training data generator.
+ *
+ * Every game starts with a few random moves, then both sides play the move of a shallow search.
+ * A few positions are sampled from every game after the random opening and labeled: with the
+ * exact final disc difference when the endgame solver can reach the end, with the score of a
+ * deeper search otherwise. Positions equal by symmetry to one already labeled are dropped, using
+ * a lock-free set of canonical position hashes shared by all the games.
+ *
+ * The output is a stream of fixed-size records, all fields little-endian:
+ *   - bytes 0-7: discs of the player to move, bit row * 8 + col
+ *   - bytes 8-15: discs of the opponent
+ *   - bytes 16-19: signed score for the player to move
+ *   - byte 20: number of empty squares
+ *   - byte 21: flags, FLAG_EXACT if the score is an exact disc difference
+ *   - byte 22: best move as a Square, NO_SQUARE if the player has to pass
+ *   - byte 23: reserved, 0
+ */
+class DataGenerator {
+public:
+    /** @brief Size of one record, in bytes. */
+    static constexpr std::size_t RECORD_SIZE = 24;
+    /** @brief Record flag: the score is the exact final disc difference. */
+    static constexpr std::uint8_t FLAG_EXACT = 1;
+
+    /**
+     * @brief Encodes one record.
+     * @param position The position, from the point of view of the player to move.
+     * @param score The score of the position.
+     * @param flags The record flags.
+     * @param bestMove The best move.
+     * @param out Buffer of RECORD_SIZE bytes to write to.
+     */
+    static void encodeRecord(const Bitboard &position, int score, std::uint8_t flags, Square bestMove,
+                             std::uint8_t *out);
+
+    /**
+     * @brief Plays the games, labels the sampled positions and writes them.
+     * @param options The generation settings.
+     * @param out The binary stream to write the records to.
+     * @param log The stream to print the progress and the statistics to.
+     * @return The number of records written.
+     */
+    static std::uint64_t generate(const DataGenOptions &options, std::ostream &out, std::ostream &log);
+};
\ No newline at end of file
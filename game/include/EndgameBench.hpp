@@ -0,0 +1,101 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Options of an endgame benchmark run.
+ */
+struct EndgameBenchOptions {
+    /** @brief Threads of the solve, 1 to solve on the calling thread, 0 for the number of hardware threads. */
+    unsigned int threads = 1;
+    /** @brief Endgame table budget in megabytes, 0 to solve without a table. */
+    std::size_t tableMegabytes = 64;
+    /** @brief Number of the first position to solve, 0 for the first one. */
+    int first = 0;
+    /** @brief Number of the last position to solve, 0 for the last one. */
+    int last = 0;
+};
+
+/**
+ * @brief Totals of an endgame benchmark run.
+ */
+struct EndgameBenchResult {
+    /** @brief Number of positions solved. */
+    int positions = 0;
+    /** @brief Number of positions whose score differs from the known one. */
+    int failures = 0;
+    /** @brief Nodes visited over all the positions. */
+    unsigned long long nodes = 0;
+    /** @brief Solve time over all the positions, in seconds. */
+    double seconds = 0;
+};
+
+/**
+ * @brief Exact solve benchmark over endgame positions of known score.
+ *
+ * A few positions are built in, so that any change breaking the exactness of the EndgameSolver
+ * shows up as a wrong score; a full suite read from a file also lets its throughput be compared
+ * with other programs. Every position is solved from an empty table.
+ */
+class EndgameBench {
+public:
+    /** @brief A position and its known score. */
+    struct Position {
+        /** @brief Number of the position in its suite. */
+        int number;
+        /** @brief The 64 squares from a1 to h8 ('X', 'O' or '-'). */
+        std::string squares;
+        /** @brief The player to move ('X' or 'O'). */
+        char player;
+        /** @brief Exact final disc difference for the player to move. */
+        int score;
+    };
+
+    /**
+     * @brief Returns the built-in positions.
+     * @return The positions, by increasing number.
+     */
+    static std::vector<Position> builtinPositions();
+
+    /**
+     * @brief Reads positions in the format of the FFO files of other programs: one position per
+     * line, the 64 squares, the player to move, then ';' and the best moves with their scores,
+     * e.g. "...-- X; A2:+38;". Positions are numbered in file order, skipping empty lines.
+     * @param in The stream to read.
+     * @param firstNumber Number of the first position, e.g. 40 for the FFO file of #40 to #59.
+     * @return The positions.
+     * @throw std::runtime_error if a line is malformed.
+     */
+    static std::vector<Position> readPositions(std::istream &in, int firstNumber = 1);
+
+    /**
+     * @brief Solves every position in the range of the options and prints one line per position,
+     * then the totals.
+     * @param positions The positions.
+     * @param options The options.
+     * @param out The stream to print to.
+     * @return The totals.
+     */
+    static EndgameBenchResult run(const std::vector<Position> &positions, const EndgameBenchOptions &options,
+                                  std::ostream &out);
+};
\ No newline at end of file
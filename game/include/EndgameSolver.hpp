@@ -0,0 +1,127 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "Bitboard.hpp"
+#include "EndgameTable.hpp"
+#include "ThreadPool.hpp"
+#include <atomic>
+#include <mutex>
+
+/**
+ * @brief Result of an exact endgame solve.
+ */
+struct EndgameResult {
+    /** @brief Best move, NO_SQUARE if the player to move has to pass or the game is over. */
+    Square bestMove = NO_SQUARE;
+    /** @brief Exact final disc difference for the player to move, with perfect play. */
+    int score = 0;
+    /** @brief Number of nodes visited. */
+    unsigned long long nodes = 0;
+};
+
+/**
+ * @brief Exact solver for the end of the game: searches every line to the last move and returns
+ * the final disc difference, empty squares counted for the winner.
+ *
+ * With a thread pool, the solver splits the work with the Young Brothers Wait Concept: at a node
+ * with enough empty squares, the first (eldest) move is searched alone to get a good bound, then
+ * the remaining (younger) moves are queued on the work-stealing pool and searched in parallel.
+ * When one of them produces a cutoff, the whole split point and everything below it is aborted.
+ * The parallel solve returns the same score as the serial one.
+ *
+ * With an EndgameTable, nodes with enough empty squares store their bounds and best move, which
+ * cut off or order the search when the position is met again through another move order. The
+ * table may be shared by the threads of the pool and kept from one solve to the next.
+ */
+class EndgameSolver {
+public:
+    /** @brief Default minimum number of empty squares of a node to split it over the pool. */
+    static constexpr int DEFAULT_SPLIT_MIN_EMPTIES = 12;
+
+    /**
+     * @brief Constructs a new Endgame Solver.
+     * @param pool Thread pool to split the search over, nullptr to search on the calling thread.
+     * @param splitMinEmpties Minimum number of empty squares of a node to split it.
+     * @param table Transposition table, nullptr to search without one.
+     */
+    explicit EndgameSolver(ThreadPool *pool = nullptr, int splitMinEmpties = DEFAULT_SPLIT_MIN_EMPTIES, EndgameTable *table = nullptr)
+        : pool(pool), splitMinEmpties(splitMinEmpties), table(table) {};
+
+    /**
+     * @brief Solves a position exactly.
+     * @param board The position, from the point of view of the player to move.
+     * @param alpha Lower bound of the window. Scores outside the window are only bounds.
+     * @param beta Upper bound of the window.
+     * @return The best move, its score and the node count.
+     */
+    EndgameResult solve(const Bitboard &board, int alpha = -64, int beta = 64);
+
+    /**
+     * @brief Solves a position exactly.
+     * @param board 2D char vector representing the board.
+     * @param player The player to move ('X' or 'O').
+     * @return The best move, its score for the player and the node count.
+     */
+    EndgameResult solve(const std::vector<std::vector<char>> &board, char player);
+
+private:
+    /** @brief Shared state of the moves of a node searched in parallel. */
+    struct SplitPoint {
+        const SplitPoint *parent;
+        const int beta;
+        std::atomic<int> alpha;
+        std::atomic<bool> aborted{false};
+        std::mutex bestMutex;
+        int bestScore;
+        Square bestMove;
+
+        SplitPoint(const SplitPoint *parent, int alpha, int beta, int bestScore, Square bestMove)
+            : parent(parent), beta(beta), alpha(alpha), bestScore(bestScore), bestMove(bestMove) {};
+    };
+
+    ThreadPool *pool;
+    int splitMinEmpties;
+    EndgameTable *table;
+    std::atomic<unsigned long long> nodes{0};
+
+    /**
+     * @brief Checks if a split point or any of its ancestors has been aborted by a cutoff.
+     */
+    static bool isAborted(const SplitPoint *splitPoint);
+
+    /**
+     * @brief Negamax alpha-beta search to the end of the game.
+     * @param board The position, from the point of view of the player to move.
+     * @param alpha Lower bound of the window.
+     * @param beta Upper bound of the window.
+     * @param passed true if the previous player had to pass.
+     * @param splitPoint Innermost split point above this node, nullptr if none.
+     * @param nodes Node counter of the calling task.
+     * @param bestMove If not nullptr, receives the best move.
+     * @return The score, meaningless if the split point was aborted meanwhile.
+     */
+    int search(const Bitboard &board, int alpha, int beta, bool passed, const SplitPoint *splitPoint,
+               unsigned long long &nodes, Square *bestMove);
+
+    /**
+     * @brief Searches the younger moves of a node in parallel, once the eldest move did not cut off.
+     * @return The best score among all moves of the node, including the eldest one.
+     */
+    int searchSplit(const Bitboard &board, const Square *moves, int moveCount, int alpha, int beta, int bestScore,
+                    Square &bestMove, const SplitPoint *parent);
+};
\ No newline at end of file
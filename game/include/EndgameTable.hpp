@@ -0,0 +1,92 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "Move.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Transposition table of the EndgameSolver.
+ *
+ * Endgame scores are exact final disc differences, so an entry keeps a lower and an upper bound of
+ * the score instead of a score and a depth, plus the best move. The bounds only tighten when the
+ * same position is searched again with another window, and an entry whose bounds are equal is the
+ * exact score.
+ *
+ * Like the EvalCache, an entry is one 64-bit word holding the upper bits of the hash and the data,
+ * read and written atomically, so every thread of a parallel solve shares the table without locks
+ * and never sees the data of one position paired with the hash of another. Positions go to a
+ * bucket of two slots: the first keeps the position with the most empty squares, the second
+ * always takes the latest store.
+ */
+class EndgameTable {
+public:
+    /** @brief What the table knows about a position. */
+    struct Entry {
+        /** @brief The score is at least lower. */
+        int lower = -64;
+        /** @brief The score is at most upper. */
+        int upper = 64;
+        /** @brief Best move found, NO_SQUARE if none. */
+        Square bestMove = NO_SQUARE;
+    };
+
+    /**
+     * @brief Constructs a new Endgame Table.
+     * @param sizeInMegabytes Memory budget. The slot count is rounded down to a power of two.
+     */
+    explicit EndgameTable(std::size_t sizeInMegabytes = 16);
+
+    /**
+     * @brief Looks up a position.
+     * @param key The hash of the position.
+     * @param entry Receives the bounds and best move if the position is stored.
+     * @return true if the position is stored, false otherwise.
+     */
+    bool probe(std::uint64_t key, Entry &entry) const;
+
+    /**
+     * @brief Stores the result of a search.
+     * @param key The hash of the position.
+     * @param empties The number of empty squares of the position.
+     * @param entry The bounds and best move found.
+     */
+    void store(std::uint64_t key, int empties, const Entry &entry);
+
+    /** @brief Empties the table. */
+    void clear();
+
+    /** @brief Returns the number of slots of the table. */
+    [[nodiscard]] std::size_t size() const { return mask + 2; }
+
+private:
+    /** @brief Low bits of a slot holding the data; the high bits hold the hash. */
+    static constexpr int DATA_BITS = 29;
+    static constexpr std::uint64_t DATA_MASK = (std::uint64_t{1} << DATA_BITS) - 1;
+
+    std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+    std::size_t mask; // index mask of the first slot of a bucket, always even
+
+    /**
+     * @brief Packs an entry: lower + 65 (never 0, so a stored slot is never 0), upper + 64, best
+     * move and empty squares.
+     */
+    static std::uint64_t pack(std::uint64_t key, int empties, const Entry &entry);
+};
\ No newline at end of file
@@ -0,0 +1,78 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Cache of static evaluations, indexed by the Zobrist hash of a position.
+ *
+ * Unlike the TranspositionTable, which keeps search results, the cache only remembers what the
+ * evaluation function returned for a leaf, so a leaf met again in another iteration or another
+ * subtree is not evaluated twice. It is direct-mapped: a position has a single slot and a store
+ * always replaces it.
+ *
+ * A slot is one 64-bit word holding the upper bits of the hash and the score, read and written
+ * atomically, so the cache can be shared by concurrent searches without locks and a reader never
+ * sees a score paired with another position's hash. It keeps no counters, which every probe of
+ * every thread would write to: each Solver counts its own lookups and hits.
+ */
+class EvalCache {
+public:
+    /**
+     * @brief Constructs a new Eval Cache.
+     * @param sizeInMegabytes Memory budget. The slot count is rounded down to a power of two.
+     */
+    explicit EvalCache(std::size_t sizeInMegabytes = 4);
+
+    /**
+     * @brief Looks up the evaluation of a position.
+     * @param key The hash of the position, including whatever the evaluation depends on besides
+     * the pieces (e.g. the point of view).
+     * @param score Receives the evaluation if the position is stored.
+     * @return true if the position is stored, false otherwise.
+     */
+    bool probe(std::uint64_t key, int &score);
+
+    /**
+     * @brief Stores the evaluation of a position. Scores outside [-MAX_SCORE, MAX_SCORE] are not stored.
+     * @param key The hash of the position.
+     * @param score The evaluation.
+     */
+    void store(std::uint64_t key, int score);
+
+    /** @brief Empties the cache. */
+    void clear();
+
+    /** @brief Returns the number of slots of the cache. */
+    [[nodiscard]] std::size_t size() const { return mask + 1; }
+
+    /** @brief Largest absolute score the cache can hold. */
+    static constexpr int MAX_SCORE = (1 << 23) - 1;
+
+private:
+    /** @brief Bits of a slot holding the score, offset by SCORE_BIAS so that 0 is never a stored slot. */
+    static constexpr int SCORE_BITS = 24;
+    static constexpr std::uint64_t SCORE_MASK = (std::uint64_t{1} << SCORE_BITS) - 1;
+    static constexpr int SCORE_BIAS = 1 << 23;
+
+    std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+    std::size_t mask;
+};
\ No newline at end of file
@@ -17,8 +17,11 @@
 
 #pragma once
 
+#include "Bitboard.hpp"
 #include "BoardHelper.hpp"
 
+class ThreadPool;
+
 /**
  * @class Evaluator
  *
@@ -48,6 +51,44 @@ class Evaluator {
      */
     static int getEvaluation(const std::vector<std::vector<char>> &board, char player);
 
+    /**
+     * @brief Evaluates many boards at once, with the scores getEvaluation gives them. The boards
+     * are evaluated several at a time in the vector registers of the active kernels, in chunks
+     * spread over the pool when one is given.
+     * @param boards The boards, from the point of view of the player the scores are for: its discs
+     * are Bitboard::player, whoever is to move. Every board has at least one disc.
+     * @param count The number of boards.
+     * @param scores Receives the count scores.
+     * @param pool The pool running the chunks, nullptr to evaluate on the calling thread.
+     */
+    static void getEvaluations(const Bitboard *boards, std::size_t count, int *scores, ThreadPool *pool = nullptr);
+
+    /** @brief Weights of the evaluation terms in one game phase. */
+    struct Weights {
+        int corner, mobility, discDiff, parity, positional, edgeControl;
+    };
+
+    static constexpr Weights EARLY_GAME_WEIGHTS = {1000, 50, 0, 0, 30, 30};
+    static constexpr Weights MID_GAME_WEIGHTS = {1000, 20, 10, 100, 50, 50};
+    static constexpr Weights LATE_GAME_WEIGHTS = {1000, 100, 500, 500, 100, 100};
+    /** @brief Weight of the disc difference, the only term once the game is over. */
+    static constexpr int FINAL_DISC_DIFF_WEIGHT = 1000;
+
+    /** @brief Disc counts from which the game is in its middle and its late phase. */
+    static constexpr int MID_GAME_DISCS = 20;
+    static constexpr int LATE_GAME_DISCS = 59;
+
+    /** @brief Value of every square for the edge control term. */
+    static constexpr int SQUARE_WEIGHTS[8][8] = {
+            {120, -20, 20, 5,  5,  20, -20, 120},
+            {-20, -40, -5, -5, -5, -5, -40, -20},
+            {20,  -5,  15, 3,  3,  15, -5,  20},
+            {5,   -5,  3,  3,  3,  3,  -5,  5},
+            {5,   -5,  3,  3,  3,  3,  -5,  5},
+            {20,  -5,  15, 3,  3,  15, -5,  20},
+            {-20, -40, -5, -5, -5, -5, -40, -20},
+            {120, -20, 20, 5,  5,  20, -20, 120}};
+
   private:
     BoardHelper bHelper;
 
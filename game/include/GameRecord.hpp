@@ -0,0 +1,165 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "BoardHelper.hpp"
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Binary game record format.
+ *
+ * A record file starts with the 8-byte MAGIC, followed by the games one after the other. A game
+ * is an 8-byte Header followed by one byte per move, the Square of the move; passes are implicit.
+ * A sidecar index file (the record path with ".idx" appended) holds the 64-bit little-endian
+ * offset of every game, so game i is found without reading the games before it.
+ */
+namespace GameRecord {
+
+/** @brief First bytes of every record file. */
+constexpr char MAGIC[8] = {'O', 'T', 'H', 'R', 'E', 'C', '0', '1'};
+
+/** @brief Header of one game. All fields are stored in this order, little-endian. */
+struct Header {
+    /** @brief Number of moves of the game. */
+    std::uint8_t moveCount = 0;
+    /** @brief Final disc difference, X minus O. */
+    std::int8_t result = 0;
+    /** @brief Free for the producer of the record, e.g. to tell a finished game from a cut one. */
+    std::uint16_t flags = 0;
+    /** @brief Free for the producer of the record, e.g. a source or tournament id. */
+    std::uint32_t metadata = 0;
+};
+
+static_assert(sizeof(Header) == 8, "a game header takes 8 bytes");
+
+/** @brief View on one game of a record file; valid as long as the reader is. */
+struct GameView {
+    Header header;
+    const std::uint8_t *moves = nullptr;
+};
+
+/**
+ * @brief Returns the final disc difference of a game, X minus O.
+ * @param moves The moves of the game.
+ * @return The disc difference.
+ * @throws std::invalid_argument if a move is illegal.
+ */
+int finalResult(const std::vector<Square> &moves);
+
+/**
+ * @brief Replays a game, calling a function with the position before every move.
+ * @param game The game.
+ * @param visit Called with the board, the player to move and the move played.
+ * @throws std::invalid_argument if a move is illegal.
+ */
+void replay(const GameView &game,
+            const std::function<void(const std::vector<std::vector<char>> &, char, Square)> &visit);
+
+/**
+ * @brief Checks if a file is a record file.
+ * @param path The path of the file.
+ * @return true if the file starts with MAGIC.
+ */
+bool isRecordFile(const std::string &path);
+
+/**
+ * @brief Appends games to a record file and its index, creating them if needed.
+ */
+class Writer {
+public:
+    /**
+     * @brief Opens a record file for appending. A game cut by a crash at the end of the file is
+     * dropped, and the index is rewritten if it does not list exactly the complete games.
+     * @param path The path of the record file.
+     * @throws std::runtime_error if the file cannot be opened or is not a record file.
+     */
+    explicit Writer(const std::string &path);
+
+    /**
+     * @brief Appends a game.
+     * @param moves The moves of the game, at most 255.
+     * @param result Final disc difference, X minus O.
+     * @param flags Free flags.
+     * @param metadata Free metadata.
+     */
+    void append(const std::vector<Square> &moves, int result, std::uint16_t flags = 0, std::uint32_t metadata = 0);
+
+    /** @brief Writes the buffered games to disk. */
+    void flush();
+
+private:
+    std::ofstream data;
+    std::ofstream index;
+    std::uint64_t offset = 0;
+
+    /**
+     * @brief Truncates an existing record file after its last complete game and brings its index
+     * in line.
+     * @param path The path of the record file.
+     * @param existing The file, opened at its end.
+     * @return The length of the file, where the next game goes.
+     * @throws std::runtime_error if the file or its index cannot be rewritten.
+     */
+    static std::uint64_t dropCutGame(const std::string &path, std::ifstream &existing);
+};
+
+/**
+ * @brief Reads a record file through a memory mapping, without copying or parsing the games.
+ */
+class Reader {
+public:
+    /**
+     * @brief Maps a record file and its index. If the index is missing or stale, the offsets are
+     * rebuilt by walking the headers.
+     * @param path The path of the record file.
+     * @throws std::runtime_error if the file cannot be mapped or is not a record file.
+     */
+    explicit Reader(const std::string &path);
+
+    ~Reader();
+
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    /** @brief Returns the number of games. */
+    [[nodiscard]] std::size_t size() const { return offsets.size(); }
+
+    /**
+     * @brief Returns a game.
+     * @param i Index of the game, in [0, size()).
+     * @return A view on the game.
+     */
+    [[nodiscard]] GameView game(std::size_t i) const;
+
+    /**
+     * @brief Calls a function for every game, in file order.
+     * @param visit The function.
+     */
+    void forEach(const std::function<void(const GameView &)> &visit) const;
+
+private:
+    const std::uint8_t *data = nullptr;
+    std::size_t length = 0;
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::uint8_t> buffer; // file contents where memory mapping is not available
+};
+
+} // namespace GameRecord
\ No newline at end of file
@@ -0,0 +1,102 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "AnalysisStore.hpp"
+#include "SearchTrace.hpp"
+#include "BoardHelper.hpp"
+#include "EndgameTable.hpp"
+#include "TranspositionTable.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Settings of a game review.
+ */
+struct ReviewOptions {
+    /** @brief Search depth of the midgame plies. */
+    int depth = 6;
+    /** @brief Plies with at most this many empty squares are solved exactly. */
+    int exactEmpties = 12;
+    /** @brief Number of games reviewed in parallel, 0 for the number of hardware threads. */
+    unsigned int threads = 0;
+    /** @brief Transposition table budget of each game, in megabytes. */
+    std::size_t tableMegabytes = 16;
+    /** @brief Persistent store of deep results, shared by the games and kept between reviews; nullptr for none. */
+    AnalysisStore *store = nullptr;
+    /** @brief Trace recording every node of the midgame searches, each game with its own writer; nullptr for none. */
+    SearchTrace *trace = nullptr;
+};
+
+/**
+ * @brief Review of one move of a game.
+ */
+struct PlyReview {
+    /** @brief The player who moved. */
+    char player;
+    /** @brief The move played. */
+    Position played;
+    /** @brief Score of the move played. */
+    int playedScore;
+    /** @brief The best move. */
+    Position best;
+    /** @brief Score of the best move. */
+    int bestScore;
+    /** @brief true if the scores are exact final disc differences, false if they are Solver scores. */
+    bool exact;
+};
+
+/**
+ * @brief Annotates recorded games: for every move, the score lost against the best move.
+ *
+ * The plies of a game are analyzed from the last one to the first, with one transposition table
+ * for the whole game: the positions met by the search of an early ply were often already searched
+ * for a later ply, so their results are reused. Independent games are reviewed in parallel.
+ */
+class GameReview {
+public:
+    /**
+     * @brief Reads games in text form: one game per line, moves as {row,col}, passes implicit.
+     * @param in The stream to read.
+     * @return The games, as their list of moves.
+     * @throws InvalidPositionFormatException if a move is malformed.
+     */
+    static std::vector<std::vector<Position>> readGames(std::istream &in);
+
+    /**
+     * @brief Reviews a game.
+     * @param moves The moves of the game, from the initial position.
+     * @param options The review settings.
+     * @param table Transposition table reused across the plies.
+     * @param endgameTable Table of the exact solver, reused across the plies.
+     * @return The review of each ply, in game order.
+     * @throws std::invalid_argument if a move is illegal.
+     */
+    static std::vector<PlyReview> reviewGame(const std::vector<Position> &moves, const ReviewOptions &options,
+                                             TranspositionTable &table, EndgameTable &endgameTable);
+
+    /**
+     * @brief Reviews games and prints the annotations.
+     * @param games The games.
+     * @param options The review settings.
+     * @param out The stream to print to.
+     * @return The number of games that could not be reviewed.
+     */
+    static int reviewGames(const std::vector<std::vector<Position>> &games, const ReviewOptions &options,
+                           std::ostream &out);
+};
\ No newline at end of file
@@ -0,0 +1,137 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "BoardHelper.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Settings of a GameServer.
+ */
+struct ServerOptions {
+    /** @brief Path of the Unix domain socket to listen on. */
+    std::string socketPath;
+    /** @brief Number of search workers shared by all sessions, 0 for the number of hardware threads. */
+    unsigned int workers = 0;
+    /** @brief Transposition table budget of each session, in megabytes. */
+    std::size_t tableMegabytes = 4;
+    /** @brief Default search depth of the AI. */
+    int depth = 6;
+    /** @brief Maximum number of searches waiting for a worker; more are refused. */
+    std::size_t maxQueuedSearches = 1024;
+};
+
+/**
+ * @brief Hosts many human-vs-AI games in one process.
+ *
+ * Clients connect to a Unix domain socket and drive their game with a line based text protocol:
+ *
+ *     new <X|O> [depth] [ai_time_ms]   start a game, playing X or O
+ *     move {row,col}                   play a move; the AI answers with "ai {row=.., col=..}"
+ *     board                            print the board
+ *     stats                            print the AI move latency percentiles of the server
+ *     quit                             close the session
+ *
+ * Each session only keeps its board, side to move, clock and its own transposition table. One
+ * I/O thread serves every socket, and the AI searches of all sessions are queued in arrival order
+ * on a bounded pool of workers; a session has at most one search queued or running, so no session
+ * can starve the others. A search is stopped when its client disconnects or its clock runs out.
+ */
+class GameServer {
+public:
+    /**
+     * @brief Constructs a new Game Server.
+     * @param options The settings of the server.
+     */
+    explicit GameServer(ServerOptions options);
+
+    ~GameServer();
+
+    GameServer(const GameServer &) = delete;
+    GameServer &operator=(const GameServer &) = delete;
+
+    /**
+     * @brief Listens and serves clients until stop() is called.
+     * @return 0 on a clean stop, 1 if the socket could not be set up.
+     */
+    int run();
+
+    /**
+     * @brief Asks run() to return. Can be called from any thread, or from a signal handler.
+     */
+    void stop() { stopping = true; }
+
+    /**
+     * @brief Plays random human moves against a server from many concurrent sessions and prints
+     * the AI move latency seen by the clients.
+     * @param socketPath Path of the socket of the server.
+     * @param sessions Number of concurrent sessions.
+     * @param games Number of games played by each session.
+     * @return 0 on success, 1 if the server could not be reached.
+     */
+    static int runLoadTest(const std::string &socketPath, int sessions, int games);
+
+    /**
+     * @brief Returns a percentile of a set of latencies.
+     * @param latencies The latencies, reordered by the call.
+     * @param percentile The percentile, in [0, 100].
+     * @return The latency, 0 if there is none.
+     */
+    static double percentile(std::vector<double> &latencies, double percentile);
+
+private:
+    struct Session;
+
+    /** @brief An AI move to compute. */
+    struct SearchJob {
+        std::shared_ptr<Session> session;
+        std::vector<std::vector<char>> board;
+        char player;
+        int depth;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+
+    ServerOptions options;
+    std::atomic<bool> stopping{false};
+
+    std::map<int, std::shared_ptr<Session>> sessions;
+
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<SearchJob> queue;
+    std::vector<std::thread> workers;
+
+    std::mutex latencyMutex;
+    std::vector<double> latencies;
+
+    void workerLoop();
+    void handleLine(const std::shared_ptr<Session> &session, const std::string &line);
+    void scheduleAiMove(const std::shared_ptr<Session> &session);
+    void finishAiMove(const SearchJob &job, Position move);
+    void checkClocks();
+    void closeSession(int fd);
+    std::string statsLine();
+};
\ No newline at end of file
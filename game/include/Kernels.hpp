@@ -0,0 +1,613 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "CpuDispatch.hpp"
+#include "Evaluator.hpp"
+#include <algorithm>
+#include <array>
+
+#if defined(__BMI2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Bodies of the kernels selected by CpuDispatch.
+ *
+ * Only included by the Kernels*.cpp files, each compiled for its own instruction set. Everything
+ * here is in an unnamed namespace, member functions of the lane types included, so each of those
+ * files gets its own build of them instead of the linker keeping a single one, and the code paths
+ * are chosen with the feature macros the compiler defines for that instruction set.
+ */
+namespace KernelImpl {
+namespace {
+
+constexpr std::uint64_t INNER_COLUMNS = 0x7E7E7E7E7E7E7E7EULL;
+constexpr std::uint64_t INNER_ROWS = 0x00FFFFFFFFFFFF00ULL;
+constexpr std::uint64_t INNER_SQUARES = INNER_COLUMNS & INNER_ROWS;
+
+static inline int popCount(std::uint64_t mask) {
+#if defined(__POPCNT__) || defined(__AVX2__)
+    return __builtin_popcountll(mask);
+#else
+    mask = mask - ((mask >> 1) & 0x5555555555555555ULL);
+    mask = (mask & 0x3333333333333333ULL) + ((mask >> 2) & 0x3333333333333333ULL);
+    mask = (mask + (mask >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((mask * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+constexpr std::uint64_t NOT_COL_A = 0xFEFEFEFEFEFEFEFEULL; // clears bits wrapped from column 7 to 0
+constexpr std::uint64_t NOT_COL_H = 0x7F7F7F7F7F7F7F7FULL; // clears bits wrapped from column 0 to 7
+
+/**
+ * Moves every disc of a mask one square in a direction: down, down-right, right, down-left (left
+ * shifts), then up, up-left, left, up-right (right shifts). Discs leaving the board disappear.
+ * Also shifts the masks of several boards at once, see the lanes of the batch evaluation.
+ */
+template<int DIRECTION, class Mask>
+static inline Mask shift(Mask mask) {
+    switch (DIRECTION) {
+        case 0: return mask << 8;
+        case 1: return (mask << 9) & NOT_COL_A;
+        case 2: return (mask << 1) & NOT_COL_A;
+        case 3: return (mask << 7) & NOT_COL_H;
+        case 4: return mask >> 8;
+        case 5: return (mask >> 9) & NOT_COL_H;
+        case 6: return (mask >> 1) & NOT_COL_H;
+        default: return (mask >> 7) & NOT_COL_A;
+    }
+}
+
+template<int DIRECTION, class Mask>
+static inline Mask movesInDirection(Mask player, Mask opponent, Mask empty) {
+    // runs of opponent discs starting next to a player disc, at most 6 long
+    Mask run = shift<DIRECTION>(player) & opponent;
+    run |= shift<DIRECTION>(run) & opponent;
+    run |= shift<DIRECTION>(run) & opponent;
+    run |= shift<DIRECTION>(run) & opponent;
+    run |= shift<DIRECTION>(run) & opponent;
+    run |= shift<DIRECTION>(run) & opponent;
+    return shift<DIRECTION>(run) & empty;
+}
+
+template<class Mask>
+static inline Mask shiftMoves(Mask player, Mask opponent) {
+    Mask empty = ~(player | opponent);
+    return movesInDirection<0>(player, opponent, empty) | movesInDirection<1>(player, opponent, empty) |
+           movesInDirection<2>(player, opponent, empty) | movesInDirection<3>(player, opponent, empty) |
+           movesInDirection<4>(player, opponent, empty) | movesInDirection<5>(player, opponent, empty) |
+           movesInDirection<6>(player, opponent, empty) | movesInDirection<7>(player, opponent, empty);
+}
+
+static inline std::uint64_t getMoves(std::uint64_t player, std::uint64_t opponent) {
+#if defined(__AVX2__)
+    // the four direction pairs at once, one per 64-bit lane; the opponent discs a run can cross
+    // are masked per direction so runs never wrap around an edge, and the runs double in length
+    // at each step once the first two discs are known
+    const __m256i shift1 = _mm256_set_epi64x(7, 9, 8, 1);
+    const __m256i shift2 = _mm256_set_epi64x(14, 18, 16, 2);
+    const __m256i masks = _mm256_set_epi64x(static_cast<long long>(INNER_SQUARES),
+                                            static_cast<long long>(INNER_SQUARES),
+                                            static_cast<long long>(INNER_ROWS),
+                                            static_cast<long long>(INNER_COLUMNS));
+    __m256i p = _mm256_set1_epi64x(static_cast<long long>(player));
+    __m256i o = _mm256_and_si256(_mm256_set1_epi64x(static_cast<long long>(opponent)), masks);
+    __m256i left = _mm256_and_si256(o, _mm256_sllv_epi64(p, shift1));
+    __m256i right = _mm256_and_si256(o, _mm256_srlv_epi64(p, shift1));
+    left = _mm256_or_si256(left, _mm256_and_si256(o, _mm256_sllv_epi64(left, shift1)));
+    right = _mm256_or_si256(right, _mm256_and_si256(o, _mm256_srlv_epi64(right, shift1)));
+    __m256i preLeft = _mm256_and_si256(o, _mm256_sllv_epi64(o, shift1));
+    __m256i preRight = _mm256_srlv_epi64(preLeft, shift1);
+    left = _mm256_or_si256(left, _mm256_and_si256(preLeft, _mm256_sllv_epi64(left, shift2)));
+    right = _mm256_or_si256(right, _mm256_and_si256(preRight, _mm256_srlv_epi64(right, shift2)));
+    left = _mm256_or_si256(left, _mm256_and_si256(preLeft, _mm256_sllv_epi64(left, shift2)));
+    right = _mm256_or_si256(right, _mm256_and_si256(preRight, _mm256_srlv_epi64(right, shift2)));
+    __m256i moves = _mm256_or_si256(_mm256_sllv_epi64(left, shift1), _mm256_srlv_epi64(right, shift1));
+    __m128i half = _mm_or_si128(_mm256_castsi256_si128(moves), _mm256_extracti128_si256(moves, 1));
+    half = _mm_or_si128(half, _mm_unpackhi_epi64(half, half));
+    return static_cast<std::uint64_t>(_mm_cvtsi128_si64(half)) & ~(player | opponent);
+#else
+    return shiftMoves(player, opponent);
+#endif
+}
+
+#if defined(__BMI2__)
+/** The four lines through every square (row, column, diagonal, anti-diagonal), and the index of
+ *  the square among the squares of each line. */
+struct SquareLines {
+    std::uint64_t masks[4];
+    int index[4];
+};
+
+constexpr std::array<SquareLines, 64> makeLines() {
+    std::array<SquareLines, 64> lines{};
+    const int rowStep[4] = {0, 1, 1, 1};
+    const int colStep[4] = {1, 0, 1, -1};
+    for (int square = 0; square < 64; square++) {
+        for (int line = 0; line < 4; line++) {
+            std::uint64_t mask = 0;
+            for (int step = -7; step <= 7; step++) {
+                int row = square / 8 + step * rowStep[line];
+                int col = square % 8 + step * colStep[line];
+                if (row >= 0 && row < 8 && col >= 0 && col < 8)
+                    mask |= 1ULL << (row * 8 + col);
+            }
+            int index = 0;
+            for (int bit = 0; bit < square; bit++)
+                index += static_cast<int>((mask >> bit) & 1);
+            lines[square].masks[line] = mask;
+            lines[square].index[line] = index;
+        }
+    }
+    return lines;
+}
+
+static constexpr std::array<SquareLines, 64> LINES = makeLines();
+
+/** Flips of a move on a line of at most 8 squares, packed in the low bits. Branchless, as the
+ *  outcome of each line is too random to predict. */
+static inline std::uint32_t lineFlips(std::uint32_t player, std::uint32_t opponent, int index) {
+    // upwards: the carry runs through the opponent discs and stops on the square after them, the
+    // only square of the line above the move that can then be both in the sum and the player's
+    std::uint32_t next = 2u << index;
+    std::uint32_t above = ~(next - 1);
+    std::uint32_t outflank = ((opponent & above) + next) & player & above;
+    std::uint32_t flips = (outflank - next) & above & (0u - (outflank != 0));
+    // downwards: the highest square below that is not the opponent's must be the player's; when
+    // there is none, bit 0 stands in for it and is never the player's
+    std::uint32_t below = (1u << index) - 1;
+    int highest = 31 - __builtin_clz((~opponent & below) | 1u);
+    flips |= below & ~((2u << highest) - 1) & (0u - ((player >> highest) & 1u));
+    return flips;
+}
+#else
+template<int DIRECTION>
+static inline std::uint64_t flipsInDirection(std::uint64_t move, std::uint64_t player, std::uint64_t opponent) {
+    std::uint64_t flips = 0;
+    std::uint64_t cursor = shift<DIRECTION>(move);
+    while (cursor & opponent) {
+        flips |= cursor;
+        cursor = shift<DIRECTION>(cursor);
+    }
+    return (cursor & player) ? flips : 0;
+}
+#endif
+
+static inline std::uint64_t getFlips(std::uint64_t player, std::uint64_t opponent, Square square) {
+#if defined(__BMI2__)
+    std::uint64_t flips = 0;
+    for (int line = 0; line < 4; line++) {
+        std::uint64_t mask = LINES[square].masks[line];
+        std::uint32_t lineFlip = lineFlips(static_cast<std::uint32_t>(_pext_u64(player, mask)),
+                                           static_cast<std::uint32_t>(_pext_u64(opponent, mask)),
+                                           LINES[square].index[line]);
+        flips |= _pdep_u64(lineFlip, mask);
+    }
+    return flips;
+#else
+    std::uint64_t move = 1ULL << square;
+    return flipsInDirection<0>(move, player, opponent) | flipsInDirection<1>(move, player, opponent) |
+           flipsInDirection<2>(move, player, opponent) | flipsInDirection<3>(move, player, opponent) |
+           flipsInDirection<4>(move, player, opponent) | flipsInDirection<5>(move, player, opponent) |
+           flipsInDirection<6>(move, player, opponent) | flipsInDirection<7>(move, player, opponent);
+#endif
+}
+
+#if defined(__AVX2__)
+/** Multiplies 32 activations by 32 weights and adds the products into eight 32-bit sums. */
+static inline __m256i multiplyAdd(__m256i sum, const std::uint8_t *input, const std::int8_t *weights) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input));
+    __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(weights));
+    // activations are at most 127, so the pairwise 16-bit sums cannot saturate
+    return _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(a, w), _mm256_set1_epi16(1)));
+}
+
+static inline std::int32_t horizontalSum(__m256i sum) {
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    return _mm_cvtsi128_si32(half);
+}
+#endif
+
+static inline std::int32_t dotProduct(const std::uint8_t *input, const std::int8_t *weights, int size) {
+#if defined(__AVX512BW__)
+    __m512i wide = _mm512_setzero_si512();
+    const __m512i ones = _mm512_set1_epi16(1);
+    int i = 0;
+    for (; i + 64 <= size; i += 64) {
+        __m512i a = _mm512_loadu_si512(input + i);
+        __m512i w = _mm512_loadu_si512(weights + i);
+        wide = _mm512_add_epi32(wide, _mm512_madd_epi16(_mm512_maddubs_epi16(a, w), ones));
+    }
+    // through memory: the lane extraction intrinsics of some compilers warn about undefined lanes
+    alignas(64) std::int32_t lanes[16];
+    _mm512_store_si512(lanes, wide);
+    __m256i sum = _mm256_add_epi32(_mm256_load_si256(reinterpret_cast<const __m256i *>(lanes)),
+                                   _mm256_load_si256(reinterpret_cast<const __m256i *>(lanes + 8)));
+    if (i < size)
+        sum = multiplyAdd(sum, input + i, weights + i);
+    return horizontalSum(sum);
+#elif defined(__AVX2__)
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < size; i += 32)
+        sum = multiplyAdd(sum, input + i, weights + i);
+    return horizontalSum(sum);
+#else
+    std::int32_t sum = 0;
+    for (int i = 0; i < size; i++)
+        sum += input[i] * weights[i];
+    return sum;
+#endif
+}
+
+static inline void addRow(std::int16_t *accumulator, const std::int16_t *row, int size, int sign) {
+#if defined(__AVX512BW__)
+    for (int i = 0; i < size; i += 32) {
+        __m512i a = _mm512_loadu_si512(accumulator + i);
+        __m512i r = _mm512_loadu_si512(row + i);
+        _mm512_storeu_si512(accumulator + i, sign > 0 ? _mm512_add_epi16(a, r) : _mm512_sub_epi16(a, r));
+    }
+#elif defined(__AVX2__)
+    for (int i = 0; i < size; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(accumulator + i));
+        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+        a = sign > 0 ? _mm256_add_epi16(a, r) : _mm256_sub_epi16(a, r);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(accumulator + i), a);
+    }
+#else
+    // wraps around like the vector additions
+    for (int i = 0; i < size; i++)
+        accumulator[i] = static_cast<std::int16_t>(sign > 0 ? accumulator[i] + row[i] : accumulator[i] - row[i]);
+#endif
+}
+
+static inline void clip(const std::int16_t *values, std::uint8_t *out, int size) {
+#if defined(__AVX2__)
+    for (int i = 0; i < size; i += 32) {
+        __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+        __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i + 16));
+        // packs saturates to [-128, 127] but interleaves the 128-bit lanes, permute puts them back
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(low, high), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_max_epi8(packed, _mm256_setzero_si256()));
+    }
+#else
+    for (int i = 0; i < size; i++)
+        out[i] = static_cast<std::uint8_t>(std::clamp<int>(values[i], 0, 127));
+#endif
+}
+
+/*
+ * Lanes of the batch evaluation. Boards lanes hold one mask per 64-bit lane and count its discs;
+ * Scores lanes hold 32-bit features and scores. The evaluation is written once over them, for the
+ * widest lanes of the instruction set, and for the scalar lanes, one board at a time, that take
+ * what is left after the last full vector.
+ */
+struct ScalarBoards {
+    static constexpr int WIDTH = 1;
+    std::uint64_t v;
+
+    static ScalarBoards load(const std::uint64_t *masks) { return {*masks}; }
+    ScalarBoards operator&(ScalarBoards other) const { return {v & other.v}; }
+    ScalarBoards operator&(std::uint64_t mask) const { return {v & mask}; }
+    ScalarBoards operator|(ScalarBoards other) const { return {v | other.v}; }
+    ScalarBoards &operator|=(ScalarBoards other) { return *this = *this | other; }
+    ScalarBoards operator~() const { return {~v}; }
+    ScalarBoards operator<<(int bits) const { return {v << bits}; }
+    ScalarBoards operator>>(int bits) const { return {v >> bits}; }
+    ScalarBoards operator-(ScalarBoards other) const { return {v - other.v}; }
+    ScalarBoards operator+(ScalarBoards other) const { return {v + other.v}; }
+    /** Product of a small signed value by a small factor, wrapping like the vector lanes. */
+    ScalarBoards times(int factor) const { return {v * static_cast<std::uint64_t>(static_cast<std::int64_t>(factor))}; }
+    ScalarBoards count() const { return {static_cast<std::uint64_t>(popCount(v))}; }
+    void store(std::int32_t *out) const { *out = static_cast<std::int32_t>(v); }
+};
+
+struct ScalarScores {
+    static constexpr int WIDTH = 1;
+    std::int32_t v;
+
+    static ScalarScores load(const std::int32_t *values) { return {*values}; }
+    static ScalarScores all(std::int32_t value) { return {value}; }
+    ScalarScores operator+(ScalarScores other) const { return {v + other.v}; }
+    ScalarScores operator-(ScalarScores other) const { return {v - other.v}; }
+    ScalarScores operator*(ScalarScores other) const { return {v * other.v}; }
+    ScalarScores operator&(ScalarScores other) const { return {v & other.v}; }
+    static ScalarScores max(ScalarScores a, ScalarScores b) { return {std::max(a.v, b.v)}; }
+    static ScalarScores quotient(ScalarScores dividend, ScalarScores divisor) { return {dividend.v / divisor.v}; }
+    /** Takes ifBelow where value < limit, otherwise elsewhere. */
+    static ScalarScores select(ScalarScores value, std::int32_t limit, ScalarScores ifBelow, ScalarScores otherwise) {
+        return value.v < limit ? ifBelow : otherwise;
+    }
+    void store(int *out) const { *out = v; }
+};
+
+#if defined(__AVX512BW__)
+// the shifts, products, maxima and conversions through their zero-masked forms: with every lane kept
+// they are the same, and the unmasked forms of some compilers warn about undefined lanes
+constexpr __mmask8 ALL_LANES = 0xFF;
+constexpr __mmask16 ALL_SCORE_LANES = 0xFFFF;
+
+struct VectorBoards {
+    static constexpr int WIDTH = 8;
+    __m512i v;
+
+    static VectorBoards load(const std::uint64_t *masks) { return {_mm512_loadu_si512(masks)}; }
+    VectorBoards operator&(VectorBoards other) const { return {_mm512_and_si512(v, other.v)}; }
+    VectorBoards operator&(std::uint64_t mask) const {
+        return {_mm512_and_si512(v, _mm512_set1_epi64(static_cast<long long>(mask)))};
+    }
+    VectorBoards operator|(VectorBoards other) const { return {_mm512_or_si512(v, other.v)}; }
+    VectorBoards &operator|=(VectorBoards other) { return *this = *this | other; }
+    VectorBoards operator~() const { return {_mm512_xor_si512(v, _mm512_set1_epi64(-1))}; }
+    VectorBoards operator<<(int bits) const { return {_mm512_maskz_sllv_epi64(ALL_LANES, v, _mm512_set1_epi64(bits))}; }
+    VectorBoards operator>>(int bits) const { return {_mm512_maskz_srlv_epi64(ALL_LANES, v, _mm512_set1_epi64(bits))}; }
+    VectorBoards operator-(VectorBoards other) const { return {_mm512_sub_epi64(v, other.v)}; }
+    VectorBoards operator+(VectorBoards other) const { return {_mm512_add_epi64(v, other.v)}; }
+    // the signed product of the low 32 bits, enough for small values
+    VectorBoards times(int factor) const {
+        return {_mm512_maskz_mul_epi32(ALL_LANES, v, _mm512_set1_epi64(factor))};
+    }
+    VectorBoards count() const {
+        // bits of every nibble from a table, then the bytes of every lane summed
+        const __m512i nibble = _mm512_set1_epi8(0x0F);
+        const __m512i bits = _mm512_set4_epi32(0x04030302, 0x03020201, 0x03020201, 0x02010100);
+        __m512i low = _mm512_shuffle_epi8(bits, _mm512_and_si512(v, nibble));
+        __m512i high = _mm512_shuffle_epi8(bits, _mm512_and_si512(_mm512_maskz_srli_epi64(ALL_LANES, v, 4), nibble));
+        return {_mm512_sad_epu8(_mm512_add_epi8(low, high), _mm512_setzero_si512())};
+    }
+    void store(std::int32_t *out) const {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm512_maskz_cvtepi64_epi32(ALL_LANES, v));
+    }
+};
+
+struct VectorScores {
+    static constexpr int WIDTH = 16;
+    __m512i v;
+
+    static VectorScores load(const std::int32_t *values) { return {_mm512_loadu_si512(values)}; }
+    static VectorScores all(std::int32_t value) { return {_mm512_set1_epi32(value)}; }
+    VectorScores operator+(VectorScores other) const { return {_mm512_add_epi32(v, other.v)}; }
+    VectorScores operator-(VectorScores other) const { return {_mm512_sub_epi32(v, other.v)}; }
+    VectorScores operator*(VectorScores other) const { return {_mm512_mullo_epi32(v, other.v)}; }
+    VectorScores operator&(VectorScores other) const { return {_mm512_and_si512(v, other.v)}; }
+    static VectorScores max(VectorScores a, VectorScores b) { return {_mm512_maskz_max_epi32(ALL_SCORE_LANES, a.v, b.v)}; }
+    // exact: the dividends are at most 6400 and the divisors at most 65, so the rounding error of
+    // the float quotient is far below the distance of any inexact quotient to the next integer
+    static VectorScores quotient(VectorScores dividend, VectorScores divisor) {
+        __m512 quotient = _mm512_div_ps(_mm512_maskz_cvtepi32_ps(ALL_SCORE_LANES, dividend.v),
+                                        _mm512_maskz_cvtepi32_ps(ALL_SCORE_LANES, divisor.v));
+        return {_mm512_maskz_cvttps_epi32(ALL_SCORE_LANES, quotient)};
+    }
+    static VectorScores select(VectorScores value, std::int32_t limit, VectorScores ifBelow, VectorScores otherwise) {
+        return {_mm512_mask_blend_epi32(_mm512_cmplt_epi32_mask(value.v, _mm512_set1_epi32(limit)), otherwise.v,
+                                        ifBelow.v)};
+    }
+    void store(int *out) const { _mm512_storeu_si512(out, v); }
+};
+#elif defined(__AVX2__)
+struct VectorBoards {
+    static constexpr int WIDTH = 4;
+    __m256i v;
+
+    static VectorBoards load(const std::uint64_t *masks) {
+        return {_mm256_loadu_si256(reinterpret_cast<const __m256i *>(masks))};
+    }
+    VectorBoards operator&(VectorBoards other) const { return {_mm256_and_si256(v, other.v)}; }
+    VectorBoards operator&(std::uint64_t mask) const {
+        return {_mm256_and_si256(v, _mm256_set1_epi64x(static_cast<long long>(mask)))};
+    }
+    VectorBoards operator|(VectorBoards other) const { return {_mm256_or_si256(v, other.v)}; }
+    VectorBoards &operator|=(VectorBoards other) { return *this = *this | other; }
+    VectorBoards operator~() const { return {_mm256_xor_si256(v, _mm256_set1_epi64x(-1))}; }
+    VectorBoards operator<<(int bits) const { return {_mm256_sllv_epi64(v, _mm256_set1_epi64x(bits))}; }
+    VectorBoards operator>>(int bits) const { return {_mm256_srlv_epi64(v, _mm256_set1_epi64x(bits))}; }
+    VectorBoards operator-(VectorBoards other) const { return {_mm256_sub_epi64(v, other.v)}; }
+    VectorBoards operator+(VectorBoards other) const { return {_mm256_add_epi64(v, other.v)}; }
+    VectorBoards times(int factor) const { return {_mm256_mul_epi32(v, _mm256_set1_epi64x(factor))}; }
+    VectorBoards count() const {
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        const __m256i bits = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3,
+                                              1, 2, 2, 3, 2, 3, 3, 4);
+        __m256i low = _mm256_shuffle_epi8(bits, _mm256_and_si256(v, nibble));
+        __m256i high = _mm256_shuffle_epi8(bits, _mm256_and_si256(_mm256_srli_epi64(v, 4), nibble));
+        return {_mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256())};
+    }
+    void store(std::int32_t *out) const {
+        __m256i packed = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm256_castsi256_si128(packed));
+    }
+};
+
+struct VectorScores {
+    static constexpr int WIDTH = 8;
+    __m256i v;
+
+    static VectorScores load(const std::int32_t *values) {
+        return {_mm256_loadu_si256(reinterpret_cast<const __m256i *>(values))};
+    }
+    static VectorScores all(std::int32_t value) { return {_mm256_set1_epi32(value)}; }
+    VectorScores operator+(VectorScores other) const { return {_mm256_add_epi32(v, other.v)}; }
+    VectorScores operator-(VectorScores other) const { return {_mm256_sub_epi32(v, other.v)}; }
+    VectorScores operator*(VectorScores other) const { return {_mm256_mullo_epi32(v, other.v)}; }
+    VectorScores operator&(VectorScores other) const { return {_mm256_and_si256(v, other.v)}; }
+    static VectorScores max(VectorScores a, VectorScores b) { return {_mm256_max_epi32(a.v, b.v)}; }
+    // exact, as for AVX-512
+    static VectorScores quotient(VectorScores dividend, VectorScores divisor) {
+        return {_mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(dividend.v), _mm256_cvtepi32_ps(divisor.v)))};
+    }
+    static VectorScores select(VectorScores value, std::int32_t limit, VectorScores ifBelow, VectorScores otherwise) {
+        return {_mm256_blendv_epi8(otherwise.v, ifBelow.v, _mm256_cmpgt_epi32(_mm256_set1_epi32(limit), value.v))};
+    }
+    void store(int *out) const { _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), v); }
+};
+#endif
+
+#if defined(__AVX512BW__) || defined(__AVX2__)
+using BoardLanes = VectorBoards;
+using ScoreLanes = VectorScores;
+#else
+using BoardLanes = ScalarBoards;
+using ScoreLanes = ScalarScores;
+#endif
+
+constexpr std::uint64_t CORNER_SQUARES = 0x8100000000000081ULL;
+constexpr std::uint64_t EDGE_SQUARES = 0x7E8181818181817EULL; // corners excluded
+
+/** The squares of every value of Evaluator::SQUARE_WEIGHTS. */
+struct SquareClass {
+    int weight;
+    std::uint64_t mask;
+};
+
+constexpr int SQUARE_CLASS_COUNT = 8;
+
+constexpr std::array<SquareClass, SQUARE_CLASS_COUNT> makeSquareClasses() {
+    std::array<SquareClass, SQUARE_CLASS_COUNT> classes{};
+    int count = 0;
+    for (int square = 0; square < 64; square++) {
+        int weight = Evaluator::SQUARE_WEIGHTS[square / 8][square % 8];
+        int index = 0;
+        while (index < count && classes[index].weight != weight)
+            index++;
+        if (index == SQUARE_CLASS_COUNT)
+            continue; // too many values, caught below
+        if (index == count)
+            classes[count++].weight = weight;
+        classes[index].mask |= 1ULL << square;
+    }
+    return classes;
+}
+
+static constexpr std::array<SquareClass, SQUARE_CLASS_COUNT> SQUARE_CLASSES = makeSquareClasses();
+
+constexpr bool coversBoard(const std::array<SquareClass, SQUARE_CLASS_COUNT> &classes) {
+    std::uint64_t covered = 0;
+    for (const SquareClass &squareClass: classes)
+        covered |= squareClass.mask;
+    return covered == ~0ULL;
+}
+
+static_assert(coversBoard(SQUARE_CLASSES), "more square values than SQUARE_CLASS_COUNT");
+
+/** Boards whose features are extracted before they are scored, enough to fill the widest lanes. */
+constexpr int EVAL_BLOCK = 64;
+
+/** The counts the evaluation terms are made of, for a block of boards: one array per count. */
+struct EvalFeatures {
+    std::int32_t playerDiscs[EVAL_BLOCK];
+    std::int32_t opponentDiscs[EVAL_BLOCK];
+    std::int32_t playerMoves[EVAL_BLOCK];
+    std::int32_t opponentMoves[EVAL_BLOCK];
+    std::int32_t playerCorners[EVAL_BLOCK];
+    std::int32_t opponentCorners[EVAL_BLOCK];
+    std::int32_t playerEdges[EVAL_BLOCK];
+    std::int32_t opponentEdges[EVAL_BLOCK];
+    std::int32_t squares[EVAL_BLOCK]; // the edge control term
+};
+
+template<class Boards>
+static inline void extractFeatures(Boards player, Boards opponent, EvalFeatures &features, int index) {
+    player.count().store(features.playerDiscs + index);
+    opponent.count().store(features.opponentDiscs + index);
+    shiftMoves(player, opponent).count().store(features.playerMoves + index);
+    shiftMoves(opponent, player).count().store(features.opponentMoves + index);
+    (player & CORNER_SQUARES).count().store(features.playerCorners + index);
+    (opponent & CORNER_SQUARES).count().store(features.opponentCorners + index);
+    (player & EDGE_SQUARES).count().store(features.playerEdges + index);
+    (opponent & EDGE_SQUARES).count().store(features.opponentEdges + index);
+    Boards squares = ((player & SQUARE_CLASSES[0].mask).count() - (opponent & SQUARE_CLASSES[0].mask).count())
+                             .times(SQUARE_CLASSES[0].weight);
+    for (int c = 1; c < SQUARE_CLASS_COUNT; c++)
+        squares = squares + ((player & SQUARE_CLASSES[c].mask).count() - (opponent & SQUARE_CLASSES[c].mask).count())
+                                    .times(SQUARE_CLASSES[c].weight);
+    squares.store(features.squares + index);
+}
+
+template<class Scores>
+static inline Scores weightTerms(const Evaluator::Weights &weights, Scores corner, Scores mobility, Scores discDiff,
+                                 Scores parity, Scores positional, Scores edgeControl) {
+    return Scores::all(weights.corner) * corner + Scores::all(weights.mobility) * mobility +
+           Scores::all(weights.discDiff) * discDiff + Scores::all(weights.parity) * parity +
+           Scores::all(weights.positional) * positional + Scores::all(weights.edgeControl) * edgeControl;
+}
+
+/** The terms and phases of Evaluator::getEvaluation, every phase computed and the right one kept. */
+template<class Scores>
+static inline void scoreFeatures(const EvalFeatures &features, int index, int *scores) {
+    const Scores one = Scores::all(1);
+    const Scores hundred = Scores::all(100);
+    Scores playerDiscs = Scores::load(features.playerDiscs + index);
+    Scores opponentDiscs = Scores::load(features.opponentDiscs + index);
+    Scores playerMoves = Scores::load(features.playerMoves + index);
+    Scores opponentMoves = Scores::load(features.opponentMoves + index);
+    Scores playerCorners = Scores::load(features.playerCorners + index);
+    Scores opponentCorners = Scores::load(features.opponentCorners + index);
+    Scores playerEdges = Scores::load(features.playerEdges + index);
+    Scores opponentEdges = Scores::load(features.opponentEdges + index);
+
+    Scores discs = playerDiscs + opponentDiscs;
+    Scores discDiff = Scores::quotient(hundred * (playerDiscs - opponentDiscs), discs);
+    Scores mobility = Scores::quotient(hundred * (playerMoves - opponentMoves), playerMoves + opponentMoves + one);
+    Scores corner =
+            Scores::quotient(hundred * (playerCorners - opponentCorners), playerCorners + opponentCorners + one);
+    // without edge discs the difference is 0, and so is its quotient by 1
+    Scores positional = Scores::quotient(hundred * (playerEdges - opponentEdges),
+                                         Scores::max(playerEdges + opponentEdges, one));
+    // 1 for an odd number of empty squares, that is of discs, -1 otherwise
+    Scores parity = (discs & one) * Scores::all(2) - one;
+    Scores edgeControl = Scores::load(features.squares + index);
+
+    Scores early = weightTerms(Evaluator::EARLY_GAME_WEIGHTS, corner, mobility, discDiff, parity, positional,
+                               edgeControl);
+    Scores mid = weightTerms(Evaluator::MID_GAME_WEIGHTS, corner, mobility, discDiff, parity, positional, edgeControl);
+    Scores late = weightTerms(Evaluator::LATE_GAME_WEIGHTS, corner, mobility, discDiff, parity, positional,
+                              edgeControl);
+    Scores score = Scores::select(discs, Evaluator::MID_GAME_DISCS, early,
+                                  Scores::select(discs, Evaluator::LATE_GAME_DISCS, mid, late));
+    // no move for either player: the game is over
+    score = Scores::select(playerMoves + opponentMoves, 1, Scores::all(Evaluator::FINAL_DISC_DIFF_WEIGHT) * discDiff,
+                           score);
+    score.store(scores + index);
+}
+
+static inline void evaluateBatch(const std::uint64_t *players, const std::uint64_t *opponents, int *scores, int count) {
+    EvalFeatures features;
+    for (int start = 0; start < count; start += EVAL_BLOCK) {
+        int size = std::min(EVAL_BLOCK, count - start);
+        int i = 0;
+        for (; i + BoardLanes::WIDTH <= size; i += BoardLanes::WIDTH)
+            extractFeatures(BoardLanes::load(players + start + i), BoardLanes::load(opponents + start + i), features,
+                            i);
+        for (; i < size; i++)
+            extractFeatures(ScalarBoards::load(players + start + i), ScalarBoards::load(opponents + start + i),
+                            features, i);
+        for (i = 0; i + ScoreLanes::WIDTH <= size; i += ScoreLanes::WIDTH)
+            scoreFeatures<ScoreLanes>(features, i, scores + start);
+        for (; i < size; i++)
+            scoreFeatures<ScalarScores>(features, i, scores + start);
+    }
+}
+
+/** The kernels of the instruction set this file is compiled for. */
+constexpr CpuDispatch::Kernels makeKernels(CpuDispatch::Isa isa, const char *name) {
+    return {isa, name, popCount, getMoves, getFlips, dotProduct, addRow, clip, evaluateBatch};
+}
+
+} // namespace
+} // namespace KernelImpl
\ No newline at end of file
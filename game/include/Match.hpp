@@ -0,0 +1,89 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "Solver.hpp"
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @brief Settings of a self-play match between two Solver configurations.
+ */
+struct MatchOptions {
+    /** @brief Number of random openings, each played twice with the colors swapped. */
+    int openings = 50;
+    /** @brief Number of games played in parallel, 0 for the number of hardware threads. Timed games should not share cores. */
+    unsigned int threads = 1;
+    /** @brief Number of uniformly random moves of every opening. */
+    int randomPlies = 8;
+    /** @brief Seed of the openings; opening i uses seed + i, so both configurations play the same ones. */
+    std::uint64_t seed = 1;
+    /** @brief Search time of every move in milliseconds, spent deepening iteratively. */
+    int timeMs = 100;
+    /** @brief Fixed search depth of every move, 0 to search for timeMs instead. */
+    int depth = 0;
+    /** @brief Transposition table budget of each engine of a game, in megabytes. */
+    std::size_t tableMegabytes = 16;
+    /** @brief Settings of the configuration under test. */
+    SearchOptions candidate;
+    /** @brief Settings of the configuration it is compared with. */
+    SearchOptions reference;
+};
+
+/**
+ * @brief Search totals of one side of a match.
+ */
+struct MatchEngineStats {
+    /** @brief Number of moves searched. */
+    long long moves = 0;
+    /** @brief Sum of the depths of the last complete iteration of every move. */
+    long long depthSum = 0;
+    /** @brief Nodes visited over all the moves. */
+    unsigned long long nodes = 0;
+};
+
+/**
+ * @brief Outcome of a match, from the point of view of the candidate.
+ */
+struct MatchResult {
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+    /** @brief Sum of the final disc differences. */
+    long long discs = 0;
+    MatchEngineStats candidate;
+    MatchEngineStats reference;
+};
+
+/**
+ * @brief Self-play comparison of two Solver configurations.
+ *
+ * Both configurations play every opening once with each color, so the bias of an opening cancels
+ * out. With a time per move, each move deepens iteratively until the time is over and plays the
+ * move of the last complete iteration: a configuration that prunes more reaches a greater depth,
+ * and the match tells if the depth gained is worth the errors of the pruning.
+ */
+class Match {
+public:
+    /**
+     * @brief Plays the match, reporting every game and the totals.
+     * @param options The match settings.
+     * @param out Stream receiving the report.
+     * @return The outcome.
+     */
+    static MatchResult run(const MatchOptions &options, std::ostream &out);
+};
\ No newline at end of file
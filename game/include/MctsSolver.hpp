@@ -0,0 +1,141 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "Bitboard.hpp"
+#include "SearchContext.hpp"
+#include "ThreadPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+/**
+ * @brief Result of a Monte Carlo tree search.
+ */
+struct MctsResult {
+    /** @brief Most visited root move, NO_SQUARE if the player to move has to pass or the game is over. */
+    Square bestMove = NO_SQUARE;
+    /** @brief Share of the playouts through the best move won by the player to move, draws counted half. */
+    double winRate = 0;
+    /** @brief Number of playouts. */
+    unsigned long long playouts = 0;
+    /** @brief Number of tree nodes allocated. */
+    unsigned long long nodes = 0;
+    /** @brief Duration of the search, in seconds. */
+    double seconds = 0;
+};
+
+/**
+ * @brief Monte Carlo tree search with UCT, an alternative to the alpha-beta Solver.
+ *
+ * Every playout walks down the tree choosing the child with the best upper confidence bound,
+ * expands the leaf it reaches, plays random moves to the end of the game on bitboards and
+ * propagates the result back to the root.
+ *
+ * With a thread pool, every worker runs playouts on the same tree. A thread going through a node
+ * adds a virtual loss to it until its result is propagated, so the other threads prefer other
+ * lines meanwhile. A leaf is expanded by the single thread that wins a compare-and-swap on its
+ * state; the others play out from the leaf instead of waiting. Nodes are taken from an arena
+ * allocated once, so the search never calls the allocator; when the arena is full the tree stops
+ * growing and the playouts go on from its leaves.
+ */
+class MctsSolver {
+public:
+    /**
+     * @brief Constructs a new MCTS Solver.
+     * @param pool Thread pool to run the playouts on, nullptr to run them on the calling thread.
+     * @param arenaNodes Maximum number of tree nodes.
+     * @param exploration Exploration constant of the upper confidence bound.
+     */
+    explicit MctsSolver(ThreadPool *pool = nullptr, std::size_t arenaNodes = 1 << 20, double exploration = 1.4);
+
+    /**
+     * @brief Searches the best move of a position.
+     * @param board The position, from the point of view of the player to move.
+     * @param budget Time budget of the search.
+     * @param maxPlayouts Maximum number of playouts, 0 for no limit.
+     * @param stopToken Token checked between playouts.
+     * @return The best move and the search statistics.
+     */
+    MctsResult search(const Bitboard &board, std::chrono::milliseconds budget, unsigned long long maxPlayouts = 0,
+                      const StopToken &stopToken = StopToken());
+
+    /**
+     * @brief Searches the best move of a player.
+     * @param board 2D char vector representing the board.
+     * @param player The player to move ('X' or 'O').
+     * @param budget Time budget of the search.
+     * @return The best move and the search statistics.
+     */
+    MctsResult search(const std::vector<std::vector<char>> &board, char player, std::chrono::milliseconds budget);
+
+private:
+    static constexpr std::uint8_t UNEXPANDED = 0;
+    static constexpr std::uint8_t EXPANDING = 1;
+    static constexpr std::uint8_t EXPANDED = 2;
+
+    /** @brief Tree node. Rewards are in half points, for the player who made the move leading here. */
+    struct Node {
+        std::atomic<std::uint32_t> visits{0};
+        std::atomic<std::uint32_t> reward{0};
+        std::atomic<std::uint32_t> virtualLoss{0};
+        std::atomic<std::uint8_t> state{UNEXPANDED};
+        std::uint32_t firstChild = 0; // published by the release store of state
+        std::uint8_t childCount = 0;
+        Square move = NO_SQUARE;
+    };
+
+    ThreadPool *pool;
+    double exploration;
+    std::size_t capacity;
+    std::unique_ptr<Node[]> arena;
+    std::atomic<std::size_t> used{0};
+    std::atomic<unsigned long long> playouts{0};
+
+    /**
+     * @brief Runs playouts until the deadline, the playout limit or a stop request.
+     * @param root The root position.
+     * @param deadline When to stop.
+     * @param maxPlayouts Maximum number of playouts, 0 for no limit.
+     * @param stopToken Token checked between playouts.
+     * @param seed Seed of the random playouts of this thread.
+     */
+    void runPlayouts(const Bitboard &root, std::chrono::steady_clock::time_point deadline,
+                     unsigned long long maxPlayouts, const StopToken &stopToken, std::uint64_t seed);
+
+    /**
+     * @brief Creates the children of a leaf, if this thread is the first to try.
+     * @param node The leaf.
+     * @param board The position of the leaf.
+     */
+    void expand(Node &node, const Bitboard &board);
+
+    /**
+     * @brief Returns the child of an expanded node with the best upper confidence bound.
+     * @param node The node.
+     * @return The child.
+     */
+    Node &selectChild(const Node &node) const;
+
+    /**
+     * @brief Plays random moves to the end of the game.
+     * @param board The position to start from, from the point of view of the player to move.
+     * @param random State of the random number generator of the thread.
+     * @return The result for the player to move, in half points: 2 for a win, 1 for a draw, 0 for a loss.
+     */
+    static std::uint32_t playout(Bitboard board, std::uint64_t &random);
+};
\ No newline at end of file
@@ -0,0 +1,123 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "Position.hpp"
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief Compact 1-byte index of a square on the board: row * 8 + col.
+ */
+using Square = std::uint8_t;
+
+/** @brief Square value used when there is no move (e.g. a pass). */
+constexpr Square NO_SQUARE = 64;
+
+/**
+ * @brief Converts a position to its square index.
+ * @param pos The position, which must be on the board.
+ * @return The square index.
+ */
+inline Square toSquare(const Position &pos) { return static_cast<Square>(pos.getRow() * 8 + pos.getCol()); }
+
+/**
+ * @brief Converts a square index to a position.
+ * @param square The square index.
+ * @return The position, or {row=-1, col=-1} for NO_SQUARE.
+ */
+inline Position toPosition(Square square) {
+    if (square >= NO_SQUARE)
+        return {static_cast<unsigned int>(-1), static_cast<unsigned int>(-1)};
+    return {static_cast<unsigned int>(square / 8), static_cast<unsigned int>(square % 8)};
+}
+
+/**
+ * @brief Fixed-capacity, stack-allocated list of moves with an inline score per move for ordering.
+ *
+ * The capacity covers every empty square of the board, so it can never overflow, whereas a
+ * reachable position is known to have at most 33 legal moves.
+ */
+class MoveList {
+public:
+    static constexpr int CAPACITY = 60;
+
+    /**
+     * @brief Appends a move with a zero score.
+     * @param square The square of the move.
+     */
+    void push(Square square) {
+        moves[count] = square;
+        scores[count] = 0;
+        count++;
+    }
+
+    /** @brief Removes every move. */
+    void clear() { count = 0; }
+
+    [[nodiscard]] int size() const { return count; }
+
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    [[nodiscard]] Square operator[](int i) const { return moves[i]; }
+
+    /** @brief Score of the i-th move, used for ordering. */
+    [[nodiscard]] int &score(int i) { return scores[i]; }
+
+    [[nodiscard]] int score(int i) const { return scores[i]; }
+
+    /**
+     * @brief Sorts the moves by decreasing score. Stable, so equal scores keep generation order.
+     */
+    void sortByScore() {
+        // insertion sort: lists are short and usually close to sorted
+        for (int i = 1; i < count; i++) {
+            Square move = moves[i];
+            int score = scores[i];
+            int j = i - 1;
+            while (j >= 0 && scores[j] < score) {
+                moves[j + 1] = moves[j];
+                scores[j + 1] = scores[j];
+                j--;
+            }
+            moves[j + 1] = move;
+            scores[j + 1] = score;
+        }
+    }
+
+    [[nodiscard]] const Square *begin() const { return moves.data(); }
+
+    [[nodiscard]] const Square *end() const { return moves.data() + count; }
+
+private:
+    std::array<Square, CAPACITY> moves;
+    std::array<int, CAPACITY> scores;
+    int count = 0;
+};
+
+/**
+ * @brief Everything needed to take back a move played with BoardHelper::playMove.
+ *
+ * A single move flips at most 19 discs (from a central square, along all eight rays).
+ */
+struct MoveUndo {
+    static constexpr int CAPACITY = 20;
+
+    Square square = NO_SQUARE;
+    int flipCount = 0;
+    std::array<Square, CAPACITY> flipped;
+};
\ No newline at end of file
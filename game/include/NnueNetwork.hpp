@@ -0,0 +1,150 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "BoardHelper.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Small efficiently updatable neural network evaluator (NNUE), an alternative to Evaluator.
+ *
+ * The first layer reads 128 binary inputs per point of view: one per square holding a disc of the
+ * player, one per square holding a disc of the opponent. Its output, the accumulator, is kept for
+ * both points of view and updated incrementally when a move is made or taken back: only the
+ * placed disc and the flipped discs change inputs, so an update costs a few vector additions
+ * instead of a pass over the board.
+ *
+ * The accumulator of the player and the one of the opponent are clipped to [0, 127] and go through
+ * two small dense layers with 8-bit weights, computed with AVX2 when the build targets it and with
+ * plain loops otherwise. The output is in the units of Evaluator::getEvaluation.
+ *
+ * Weight file layout, all little-endian:
+ *   - MAGIC (8 bytes)
+ *   - first layer weights: int16[INPUTS][HIDDEN], the player's squares then the opponent's
+ *   - first layer biases: int16[HIDDEN]
+ *   - second layer weights: int8[DENSE][2 * HIDDEN], biases: int32[DENSE]
+ *   - output weights: int8[DENSE], bias: int32
+ * The second layer sums are shifted right by DENSE_SHIFT before clipping, the output by OUTPUT_SHIFT.
+ */
+class NnueNetwork {
+public:
+    /** @brief First bytes of every weight file. */
+    static constexpr char MAGIC[8] = {'O', 'T', 'H', 'N', 'N', 'U', 'E', '1'};
+    /** @brief Number of inputs of the first layer. */
+    static constexpr int INPUTS = 128;
+    /** @brief Number of outputs of the first layer, per point of view. */
+    static constexpr int HIDDEN = 64;
+    /** @brief Number of outputs of the second layer. */
+    static constexpr int DENSE = 32;
+    /** @brief Right shift of the second layer sums. */
+    static constexpr int DENSE_SHIFT = 6;
+    /** @brief Right shift of the output sum. */
+    static constexpr int OUTPUT_SHIFT = 4;
+
+    /** @brief Output of the first layer for both points of view, index 0 for X and 1 for O. */
+    struct Accumulator {
+        alignas(32) std::int16_t values[2][HIDDEN];
+    };
+
+    /**
+     * @brief Loads a network.
+     * @param path The weight file.
+     * @throws std::runtime_error if the file cannot be read or does not hold a network.
+     */
+    explicit NnueNetwork(const std::string &path);
+
+    /**
+     * @brief Writes a network of random weights, small enough for the accumulator never to wrap,
+     * e.g. as a fixture of tests or to try --weights before a network is trained.
+     * @param path The weight file to write.
+     * @param seed Seed of the weights; the same seed writes the same file.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    static void writeRandom(const std::string &path, std::uint64_t seed);
+
+    /**
+     * @brief Computes the accumulator of a board from scratch.
+     * @param accumulator Receives the accumulator.
+     * @param board The board.
+     */
+    void refresh(Accumulator &accumulator, const std::vector<std::vector<char>> &board) const;
+
+    /**
+     * @brief Updates an accumulator for a move just played.
+     * @param accumulator The accumulator of the board before the move.
+     * @param undo The record of the move, as filled by BoardHelper::playMove.
+     * @param mover The player who moved ('X' or 'O').
+     */
+    void applyMove(Accumulator &accumulator, const MoveUndo &undo, char mover) const;
+
+    /**
+     * @brief Updates an accumulator for a move taken back, reverting applyMove exactly.
+     * @param accumulator The accumulator of the board after the move.
+     * @param undo The record of the move.
+     * @param mover The player who moved ('X' or 'O').
+     */
+    void undoMove(Accumulator &accumulator, const MoveUndo &undo, char mover) const;
+
+    /**
+     * @brief Evaluates a position from its accumulator.
+     * @param accumulator The accumulator of the position.
+     * @param player The player whose point of view is wanted ('X' or 'O').
+     * @return The evaluation score for the player.
+     */
+    [[nodiscard]] int evaluate(const Accumulator &accumulator, char player) const;
+
+    /**
+     * @brief Evaluates a board, computing its accumulator from scratch.
+     * @param board The board.
+     * @param player The player whose point of view is wanted ('X' or 'O').
+     * @return The evaluation score for the player.
+     */
+    [[nodiscard]] int evaluate(const std::vector<std::vector<char>> &board, char player) const;
+
+    /**
+     * @brief Returns the name of the kernels in use, as selected by CpuDispatch.
+     * @return The name of the instruction set, e.g. "avx2".
+     */
+    static const char *kernelName();
+
+    /**
+     * @brief Returns a hash of the weight file, telling networks apart, e.g. in stored results.
+     * @return The hash.
+     */
+    [[nodiscard]] std::uint64_t getChecksum() const { return checksum; }
+
+private:
+    alignas(32) std::int16_t inputWeights[INPUTS][HIDDEN];
+    alignas(32) std::int16_t inputBiases[HIDDEN];
+    alignas(32) std::int8_t denseWeights[DENSE][2 * HIDDEN];
+    std::int32_t denseBiases[DENSE];
+    alignas(32) std::int8_t outputWeights[DENSE];
+    std::int32_t outputBias;
+    std::uint64_t checksum = 0;
+
+    /**
+     * @brief Moves one disc change into an accumulator.
+     * @param accumulator The accumulator.
+     * @param color 0 for X, 1 for O: the player who gets the disc.
+     * @param square The square of the disc.
+     * @param flip true if the disc was the opponent's before, false if the square was empty.
+     * @param sign 1 to apply the change, -1 to revert it.
+     */
+    void updateDisc(Accumulator &accumulator, int color, Square square, bool flip, int sign) const;
+};
\ No newline at end of file
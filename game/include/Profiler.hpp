@@ -0,0 +1,128 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @brief Scoped timing probes on the hot paths of the search.
+ *
+ * Probes are only compiled in when OTHELLO_PROFILE is defined (CMake option OTHELLO_PROFILE);
+ * otherwise PROFILE_SCOPE expands to nothing and costs nothing. When compiled in, every probe
+ * reads the cycle counter (rdtsc on x86, steady_clock elsewhere) when its scope is entered and
+ * left. Each thread records into its own call tree and per-probe histograms, without locks; the
+ * threads' records are merged when a report is printed, which must happen while no search runs.
+ */
+namespace Profiler {
+
+/** @brief The probed code paths. */
+enum Probe : std::uint8_t {
+    SEARCH,
+    MOVE_GENERATION,
+    FLIPS,
+    EVALUATION,
+    EVAL_DISC_DIFF,
+    EVAL_MOBILITY,
+    EVAL_CORNER,
+    EVAL_PARITY,
+    EVAL_POSITIONAL,
+    EVAL_EDGE_CONTROL,
+    PROBE_COUNT
+};
+
+#if defined(OTHELLO_PROFILE)
+/** @brief true if the probes are compiled in. */
+constexpr bool ENABLED = true;
+#else
+/** @brief true if the probes are compiled in. */
+constexpr bool ENABLED = false;
+#endif
+
+/**
+ * @brief Returns the name of a probe.
+ * @param probe The probe.
+ * @return The name, without spaces.
+ */
+const char *probeName(Probe probe);
+
+/**
+ * @brief Reads the cycle counter.
+ * @return The counter, in ticks.
+ */
+std::uint64_t ticks();
+
+/**
+ * @brief Records the entry into a probe on the calling thread.
+ * @param probe The probe.
+ */
+void enter(Probe probe);
+
+/**
+ * @brief Records the exit from the innermost probe entered on the calling thread.
+ * @param elapsed Ticks spent in the probe.
+ */
+void leave(std::uint64_t elapsed);
+
+/**
+ * @brief Times the scope it lives in.
+ */
+class Scope {
+public:
+    explicit Scope(Probe probe) {
+        enter(probe);
+        start = ticks();
+    }
+
+    ~Scope() { leave(ticks() - start); }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    std::uint64_t start;
+};
+
+/**
+ * @brief Forgets everything recorded so far, on every thread.
+ */
+void reset();
+
+/**
+ * @brief Prints, for every probe, its calls, self time and duration percentiles, merged over all threads.
+ * @param out The stream to print to.
+ */
+void printTable(std::ostream &out);
+
+/**
+ * @brief Prints the self time of every stack of probes, in the collapsed format of flame graph
+ * tools: one "outer;inner;innermost ticks" line per stack.
+ * @param out The stream to print to.
+ */
+void printCollapsed(std::ostream &out);
+
+} // namespace Profiler
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if defined(OTHELLO_PROFILE)
+/** @brief Times the enclosing scope as the given Profiler::Probe. */
+#define PROFILE_SCOPE(probe) Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(Profiler::probe)
+#else
+#define PROFILE_SCOPE(probe) ((void) 0)
+#endif
\ No newline at end of file
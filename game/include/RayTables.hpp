@@ -0,0 +1,89 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "Move.hpp"
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief Compile-time tables describing, for every square, the squares around it.
+ *
+ * Walking a ray from the table never leaves the board, so flip detection and move validation
+ * need no bounds checks. The tables are constexpr: they are built by the compiler and cost
+ * nothing at startup.
+ */
+namespace RayTables {
+
+/** @brief Number of directions around a square. */
+constexpr int DIRECTION_COUNT = 8;
+
+/** @brief Row step of each direction: up, up-right, right, down-right, down, down-left, left, up-left. */
+constexpr int DIRECTION_ROW[DIRECTION_COUNT] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+/** @brief Column step of each direction, in the same order as DIRECTION_ROW. */
+constexpr int DIRECTION_COL[DIRECTION_COUNT] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+/**
+ * @brief Squares met when walking from a square towards the edge of the board, nearest first.
+ */
+struct Ray {
+    std::uint8_t length = 0;
+    std::array<Square, 7> squares{};
+};
+
+/**
+ * @brief The eight rays and the neighbors of one square.
+ */
+struct SquareRays {
+    /** @brief Bit d is set if the ray in direction d can hold a flip (length of at least 2). */
+    std::uint8_t directionMask = 0;
+    std::array<Ray, DIRECTION_COUNT> rays{};
+    std::uint8_t neighborCount = 0;
+    std::array<Square, DIRECTION_COUNT> neighbors{};
+};
+
+constexpr std::array<SquareRays, 64> makeTable() {
+    std::array<SquareRays, 64> table{};
+    for (int square = 0; square < 64; square++) {
+        SquareRays &entry = table[square];
+        for (int d = 0; d < DIRECTION_COUNT; d++) {
+            Ray &ray = entry.rays[d];
+            int row = square / 8 + DIRECTION_ROW[d];
+            int col = square % 8 + DIRECTION_COL[d];
+            while (row >= 0 && row < 8 && col >= 0 && col < 8) {
+                ray.squares[ray.length++] = static_cast<Square>(row * 8 + col);
+                row += DIRECTION_ROW[d];
+                col += DIRECTION_COL[d];
+            }
+            if (ray.length >= 2)
+                entry.directionMask |= static_cast<std::uint8_t>(1u << d);
+            if (ray.length >= 1)
+                entry.neighbors[entry.neighborCount++] = ray.squares[0];
+        }
+    }
+    return table;
+}
+
+/** @brief Rays and neighbors of every square, indexed by Square. */
+inline constexpr std::array<SquareRays, 64> SQUARES = makeTable();
+
+static_assert(SQUARES[0].directionMask == 0b00011100, "a1 only looks right and down");
+static_assert(SQUARES[27].rays[3].length == 4, "d4 has four squares towards h8");
+static_assert(SQUARES[63].neighborCount == 3, "h8 has three neighbors");
+
+} // namespace RayTables
\ No newline at end of file
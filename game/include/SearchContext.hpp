@@ -0,0 +1,244 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "Position.hpp"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+
+/**
+ * @brief Read side of a cooperative cancellation flag.
+ *
+ * A default constructed token is never stopped. Copies share the same flag, so a token can be
+ * handed to any number of searches and all of them observe the same stop request.
+ */
+class StopToken {
+public:
+    StopToken() = default;
+
+    /**
+     * @brief Checks if a stop has been requested through the owning StopSource.
+     * @return true if the search should abort as soon as possible, false otherwise.
+     */
+    [[nodiscard]] bool stopRequested() const {
+        return flag && flag->load(std::memory_order_relaxed);
+    }
+
+private:
+    explicit StopToken(std::shared_ptr<std::atomic<bool>> flag) : flag(std::move(flag)) {};
+
+    std::shared_ptr<std::atomic<bool>> flag;
+
+    friend class StopSource;
+};
+
+/**
+ * @brief Write side of a cooperative cancellation flag.
+ */
+class StopSource {
+public:
+    /**
+     * @brief Constructs a new Stop Source with a fresh, unset flag.
+     */
+    StopSource() : flag(std::make_shared<std::atomic<bool>>(false)) {};
+
+    /**
+     * @brief Asks every search holding a token of this source to stop.
+     */
+    void requestStop() { flag->store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns a token observing this source.
+     * @return The stop token.
+     */
+    [[nodiscard]] StopToken getToken() const { return StopToken(flag); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag;
+};
+
+/**
+ * @brief Per-search state of the Solver.
+ *
+ * Every search owns its own context, so any number of searches can run concurrently in one
+ * process. The context is written by the search thread and may be read at any time by other
+ * threads to get the best move found so far.
+ */
+class SearchContext {
+public:
+    /**
+     * @brief Constructs a new Search Context.
+     * @param stopToken Token checked by the search at every node.
+     */
+    explicit SearchContext(StopToken stopToken = StopToken()) : stopToken(std::move(stopToken)) {};
+
+    SearchContext(const SearchContext &) = delete;
+    SearchContext &operator=(const SearchContext &) = delete;
+
+    /**
+     * @brief Checks if the search has been asked to stop.
+     * @return true if the search must abort, false otherwise.
+     */
+    [[nodiscard]] bool stopRequested() const {
+        return stopToken.stopRequested() || deadlinePassed.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sets a hard time limit: once it is passed, stopRequested returns true. The clock is
+     * read every DEADLINE_CHECK_INTERVAL nodes, so the search stops shortly after the limit.
+     * @param limit The time limit.
+     */
+    void setDeadline(std::chrono::steady_clock::time_point limit);
+
+    /**
+     * @brief Removes the time limit.
+     */
+    void clearDeadline();
+
+    /** @brief Number of nodes between two reads of the clock when a deadline is set. */
+    static constexpr unsigned long long DEADLINE_CHECK_INTERVAL = 1024;
+
+    /**
+     * @brief Checks if a root move has been fully searched yet.
+     * @return true if getBestMoveSoFar returns a legal move, false otherwise.
+     */
+    [[nodiscard]] bool hasBestMove() const;
+
+    /**
+     * @brief Returns the best root move among the ones fully searched so far.
+     * @return The best move so far, or {row=-1, col=-1} if no root move has been searched yet.
+     */
+    [[nodiscard]] Position getBestMoveSoFar() const;
+
+    /**
+     * @brief Returns the score of the best move so far.
+     * @return The score, from the point of view of the searching player.
+     */
+    [[nodiscard]] int getBestScoreSoFar() const;
+
+    /**
+     * @brief Returns the number of nodes visited by the search.
+     * @return The node count.
+     */
+    [[nodiscard]] unsigned long long getNodeCount() const { return nodes.load(std::memory_order_relaxed); }
+
+private:
+    StopToken stopToken;
+    std::atomic<unsigned long long> nodes{0};
+
+    std::chrono::steady_clock::time_point deadline;
+    bool hasDeadline = false;
+    std::atomic<bool> deadlinePassed{false};
+
+    mutable std::mutex bestMoveMutex;
+    Position bestMove = Position(-1, -1);
+    int bestScore = 0;
+    bool bestMoveFound = false;
+
+    /**
+     * @brief Counts one more visited node. Only called from the search thread.
+     */
+    void addNode() {
+        unsigned long long count = nodes.load(std::memory_order_relaxed) + 1;
+        nodes.store(count, std::memory_order_relaxed);
+        if (hasDeadline && count % DEADLINE_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline)
+            deadlinePassed.store(true, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Publishes a new best root move.
+     * @param move The move.
+     * @param score The score of the move.
+     */
+    void setBestMove(const Position &move, int score);
+
+    /**
+     * @brief Forgets the best move, before a new search reuses this context.
+     */
+    void reset();
+
+    friend class Solver;
+};
+
+/**
+ * @brief Handle on a search running in the background, as returned by Solver::startSearch.
+ *
+ * The handle is move-only. Destroying a handle whose search is still running stops the search
+ * and waits for it, so a search never outlives the object that started it.
+ */
+class SearchHandle {
+public:
+    SearchHandle() = default;
+    SearchHandle(SearchHandle &&other) noexcept = default;
+    SearchHandle &operator=(SearchHandle &&other) noexcept;
+    ~SearchHandle();
+
+    /**
+     * @brief Asks the search to stop. The result then holds the best move found so far.
+     */
+    void stop();
+
+    /**
+     * @brief Checks if the search has finished, either completed or stopped.
+     * @return true if get() will not block, false otherwise.
+     */
+    [[nodiscard]] bool isReady() const;
+
+    /**
+     * @brief Waits for the search to finish for at most the given duration.
+     * @param timeout The maximum time to wait.
+     * @return true if the search has finished, false otherwise.
+     */
+    bool waitFor(std::chrono::milliseconds timeout) const;
+
+    /**
+     * @brief Returns the best move found so far, without waiting.
+     * @return The best move so far, or {row=-1, col=-1} if no root move has been searched yet.
+     */
+    [[nodiscard]] Position getBestMoveSoFar() const;
+
+    /**
+     * @brief Returns the number of nodes visited so far.
+     * @return The node count.
+     */
+    [[nodiscard]] unsigned long long getNodeCount() const;
+
+    /**
+     * @brief Waits for the search to finish and returns its best move. Can only be called once.
+     * @return The best move for the player.
+     */
+    Position get();
+
+    /**
+     * @brief Checks if the handle refers to a search.
+     * @return true if the handle has a search whose result was not taken yet.
+     */
+    [[nodiscard]] bool isValid() const { return result.valid(); }
+
+private:
+    SearchHandle(std::shared_ptr<SearchContext> context, StopSource stopSource, std::future<Position> result)
+        : context(std::move(context)), stopSource(std::move(stopSource)), result(std::move(result)) {};
+
+    std::shared_ptr<SearchContext> context;
+    StopSource stopSource;
+    std::future<Position> result;
+
+    friend class Solver;
+};
\ No newline at end of file
@@ -0,0 +1,193 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "Move.hpp"
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Binary trace of the nodes visited by Solver searches.
+ *
+ * A trace file starts with the 8-byte MAGIC, followed by chunks. A chunk is the 32-bit id of the
+ * Writer that filled it and its 32-bit record count, then the records, all little-endian. Every
+ * search thread fills its own Writer, of bounded size, and appends it to the file as one chunk
+ * when it is full, so the threads only synchronize once per chunk.
+ *
+ * Nodes are recorded when their subtree is done, so the records of one Writer come in post-order:
+ * the descendants of a node come right before it, and the next record of a lower ply is the
+ * parent. Every root search ends with a KIND_ROOT record at ply 0.
+ */
+class SearchTrace {
+public:
+    /** @brief First bytes of every trace file. */
+    static constexpr char MAGIC[8] = {'O', 'T', 'H', 'T', 'R', 'C', '0', '1'};
+
+    /** @brief Size of one encoded record, in bytes. */
+    static constexpr std::size_t RECORD_SIZE = 24;
+
+    /** @brief Cutoff index of a node that did not cut off. */
+    static constexpr std::uint8_t NO_CUTOFF = 0xFF;
+
+    /** @brief Record flag: the node is a maximizing one. */
+    static constexpr std::uint8_t FLAG_MAX = 1;
+
+    /** @brief How a node got its score. */
+    enum Kind : std::uint8_t {
+        KIND_INTERIOR, // its moves were searched
+        KIND_LEAF,     // evaluated, at the depth limit or at the end of the game
+        KIND_TABLE,    // answered by the transposition table or the analysis store
+        KIND_PASS,     // the player to move had to pass
+        KIND_FUTILITY, // cut by futility pruning
+        KIND_ROOT      // end of a root search
+    };
+
+    /**
+     * @brief One visited node. Encoded in this order: ply, depth, move, kind, cutoff index, move
+     * count, flags, a reserved byte, then alpha, beta, score and nodes on 4 bytes each.
+     */
+    struct Record {
+        /** @brief Distance from the root, in plies. */
+        std::uint8_t ply = 0;
+        /** @brief Remaining depth. */
+        std::uint8_t depth = 0;
+        /** @brief Move leading to the node, NO_SQUARE for a pass or the root. */
+        Square move = NO_SQUARE;
+        Kind kind = KIND_INTERIOR;
+        /** @brief Index in search order of the move that cut off, NO_CUTOFF if none did. */
+        std::uint8_t cutoffIndex = NO_CUTOFF;
+        /** @brief Number of moves of the player to move. */
+        std::uint8_t moveCount = 0;
+        std::uint8_t flags = 0;
+        /** @brief Search window, as given to the node. */
+        std::int32_t alpha = 0;
+        std::int32_t beta = 0;
+        /** @brief Score returned by the node. */
+        std::int32_t score = 0;
+        /** @brief Nodes of the subtree, the node included; saturates at 2^32 - 1. */
+        std::uint32_t nodes = 0;
+    };
+
+    /**
+     * @brief Encodes one record.
+     * @param record The record.
+     * @param out Receives the RECORD_SIZE bytes of the record.
+     */
+    static void encodeRecord(const Record &record, std::uint8_t *out);
+
+    /**
+     * @brief Decodes one record.
+     * @param in The RECORD_SIZE bytes of the record.
+     * @return The record.
+     */
+    static Record decodeRecord(const std::uint8_t *in);
+
+    /**
+     * @brief Per-thread record buffer, appended to the trace as one chunk whenever it is full and
+     * when it is destroyed. Must not outlive its trace.
+     */
+    class Writer {
+    public:
+        /**
+         * @brief Constructs a new Writer with an id of its own.
+         * @param trace The trace to append to.
+         * @param capacity Number of records buffered before a chunk is written.
+         */
+        explicit Writer(SearchTrace &trace, std::size_t capacity = DEFAULT_CAPACITY);
+
+        ~Writer() { flush(); }
+
+        Writer(const Writer &) = delete;
+        Writer &operator=(const Writer &) = delete;
+
+        /**
+         * @brief Adds a record to the buffer.
+         * @param record The record.
+         */
+        void record(const Record &record) {
+            encodeRecord(record, &buffer[count * RECORD_SIZE]);
+            if (++count == capacity)
+                flush();
+        }
+
+        /**
+         * @brief Appends the buffered records to the trace as a chunk.
+         */
+        void flush();
+
+        /** @brief Default capacity, in records. */
+        static constexpr std::size_t DEFAULT_CAPACITY = 4096;
+
+    private:
+        SearchTrace &trace;
+        std::uint32_t id;
+        std::size_t capacity;
+        std::size_t count = 0;
+        std::vector<std::uint8_t> buffer;
+    };
+
+    /**
+     * @brief Creates a trace file, replacing any file of that path.
+     * @param path The path of the file.
+     * @throws std::runtime_error if the file cannot be created.
+     */
+    explicit SearchTrace(const std::string &path);
+
+    /**
+     * @brief Reads the chunks of a trace file.
+     * @param in Stream of the trace file.
+     * @param visit Called with the writer id and the records of every chunk, in file order.
+     * @throws std::runtime_error if the stream is not a trace file or is truncated.
+     */
+    template<typename Visit>
+    static void read(std::istream &in, Visit visit);
+
+private:
+    std::ofstream out;
+    std::mutex mutex;
+    std::uint32_t nextWriterId = 0;
+
+    /**
+     * @brief Reads and checks the magic of a trace file.
+     * @param in Stream of the trace file.
+     * @throws std::runtime_error if the stream is not a trace file.
+     */
+    static void readMagic(std::istream &in);
+
+    /**
+     * @brief Reads the next chunk of a trace file.
+     * @param in Stream of the trace file, after the magic.
+     * @param writerId Receives the id of the writer of the chunk.
+     * @param records Receives the records of the chunk.
+     * @return false at the end of the file.
+     * @throws std::runtime_error if the chunk is truncated.
+     */
+    static bool readChunk(std::istream &in, std::uint32_t &writerId, std::vector<Record> &records);
+};
+
+template<typename Visit>
+void SearchTrace::read(std::istream &in, Visit visit) {
+    readMagic(in);
+    std::uint32_t writerId;
+    std::vector<Record> records;
+    while (readChunk(in, writerId, records))
+        visit(writerId, records);
+}
\ No newline at end of file
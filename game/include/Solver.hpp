@@ -17,13 +17,190 @@
 
 #pragma once
 
+#include "AnalysisStore.hpp"
+#include "Bitboard.hpp"
 #include "BoardHelper.hpp"
+#include "EvalCache.hpp"
 #include "Evaluator.hpp"
+#include "NnueNetwork.hpp"
+#include "SearchContext.hpp"
+#include "SearchTrace.hpp"
+#include "TimeManager.hpp"
+#include "TranspositionTable.hpp"
 
+/**
+ * @brief Result of the analysis of one root move.
+ */
+struct MoveAnalysis {
+    /** @brief The analyzed move. */
+    Position move;
+    /** @brief Exact score of the move, from the point of view of the analyzing player. */
+    int score;
+    /** @brief Principal variation: the move followed by the expected best replies. */
+    std::vector<Position> pv;
+};
+
+/**
+ * @brief One zero-window pass of an MTD(f) search.
+ */
+struct MtdfPass {
+    /** @brief Depth of the search. */
+    int depth;
+    /** @brief The window of the pass is (beta - 1, beta). */
+    int beta;
+    /** @brief Result of the pass: a lower bound of the value if at least beta, an upper bound otherwise. */
+    int score;
+    /** @brief Nodes visited by the pass. */
+    unsigned long long nodes;
+};
+
+/**
+ * @brief Search settings of a Solver. All are off by default, so the depth of a search is the
+ * full width depth and the root moves are searched with a full window.
+ */
+struct SearchOptions {
+    /**
+     * @brief Searches the moves ordered late at a reduced depth, and again at full depth only if
+     * the reduced search finds they improve on the best move so far.
+     */
+    bool lateMoveReductions = false;
+    /**
+     * @brief Cuts the nodes next to the leaves whose static evaluation is so far outside the
+     * window that a move is unlikely to bring it back.
+     */
+    bool futilityPruning = false;
+    /**
+     * @brief Finds the value of the root by MTD(f) in search, searchSquare and searchTimed: a
+     * sequence of zero-window searches, each one moving a bound of the value towards the score of
+     * the previous one, until both bounds meet. Every pass relies on the bounds the previous ones
+     * left in the transposition table, so it only helps a Solver that has one.
+     */
+    bool mtdf = false;
+};
+
+/**
+ * @brief Alpha-beta search for the best move.
+ *
+ * A Solver runs one search at a time and reports into the SearchContext it was built with. Use
+ * one Solver per concurrent search, or startSearch to run a search in the background.
+ */
 class Solver {
 
   public:
 
+    /**
+     * @brief Constructs a new Solver reporting into the given context.
+     * @param context Per-search state. Must outlive the Solver.
+     */
+    explicit Solver(SearchContext &context) : context(context) {};
+
+    /**
+     * @brief Constructs a new Solver reporting into the given context and caching results in the
+     * given transposition table.
+     * @param context Per-search state. Must outlive the Solver.
+     * @param table Transposition table, kept between searches. nullptr to search without one.
+     */
+    Solver(SearchContext &context, TranspositionTable *table) : context(context), table(table) {};
+
+    /**
+     * @brief Constructs a new Solver evaluating the leaves with a neural network instead of Evaluator.
+     * @param context Per-search state. Must outlive the Solver.
+     * @param table Transposition table, kept between searches. nullptr to search without one.
+     * @param network The network, nullptr to use Evaluator. Must outlive the Solver.
+     * @param evalCache Cache of the leaf evaluations, nullptr to evaluate every leaf. It may be
+     * shared by several Solvers using the same evaluation.
+     * @param store Persistent store of deep results, looked up when the table misses. nullptr to
+     * search without one. It may be shared by several Solvers, whatever their evaluation.
+     */
+    Solver(SearchContext &context, TranspositionTable *table, const NnueNetwork *network,
+           EvalCache *evalCache = nullptr, AnalysisStore *store = nullptr)
+        : context(context), table(table), network(network), evalCache(evalCache), store(store) {};
+
+    /**
+     * @brief Sets the selective search settings used by the next searches.
+     * @param searchOptions The settings.
+     */
+    void setOptions(const SearchOptions &searchOptions) { options = searchOptions; }
+
+    /**
+     * @brief Records every node of the next searches into a trace, or stops recording.
+     * @param writer The buffer of the thread running this Solver, nullptr to stop recording.
+     */
+    void setTrace(SearchTrace::Writer *writer) { trace = writer; }
+
+    /**
+     * @brief Searches the best move for a player, until done or until the context is stopped.
+     * @param board Current game board state represented as a 2D character std::vector.
+     * @param player Character representing the player ('X' or 'O').
+     * @param depth Depth of the search tree.
+     * @return Position Best move found, {row=-1, col=-1} if no root move could be searched.
+     */
+    Position search(const std::vector<std::vector<char>> &board, char player, int depth);
+
+    /**
+     * @brief Searches the best move for a player by iterative deepening, within the time given by
+     * a time manager.
+     *
+     * Each iteration searches one ply deeper than the previous one, until the time manager has no
+     * time left for another iteration. The hard limit of the time manager aborts the running
+     * iteration, whose result is then discarded for the one of the last complete iteration.
+     * @param board Current game board state represented as a 2D character std::vector.
+     * @param player Character representing the player ('X' or 'O').
+     * @param timeManager The time manager, whose move has been started.
+     * @param maxDepth Depth of the last iteration.
+     * @return Position Best move found, {row=-1, col=-1} if the player has no move.
+     */
+    Position searchTimed(const std::vector<std::vector<char>> &board, char player, TimeManager &timeManager,
+                         int maxDepth = 64);
+
+    /**
+     * @brief Same as search, returning the compact square index of the move.
+     * @param board Current game board state represented as a 2D character std::vector.
+     * @param player Character representing the player ('X' or 'O').
+     * @param depth Depth of the search tree.
+     * @return Square Best move found, NO_SQUARE if no root move could be searched.
+     */
+    Square searchSquare(const std::vector<std::vector<char>> &board, char player, int depth);
+
+    /**
+     * @brief Scores the best root moves of a player in a single search.
+     *
+     * The first multiPv moves are searched with a full window. Every later move is searched with
+     * its lower bound raised to the score of the current last of the best multiPv moves, so moves
+     * that cannot enter the ranking are cut off cheaply.
+     * @param board Current game board state represented as a 2D character std::vector.
+     * @param player Character representing the player ('X' or 'O').
+     * @param depth Depth of the search tree.
+     * @param multiPv Number of moves to rank, 0 for all of them.
+     * @return The best moves by decreasing score, equal scores in board order. If the context was
+     * stopped, only the moves searched so far are ranked.
+     */
+    std::vector<MoveAnalysis> analyze(const std::vector<std::vector<char>> &board, char player, int depth,
+                                      int multiPv = 0);
+
+    /**
+     * @brief Scores a position for the player to move without ranking its moves, e.g. one where
+     * the player has to pass: the search goes on after the pass, and a finished game is scored by
+     * its discs.
+     * @param board Current game board state represented as a 2D character std::vector.
+     * @param player Character representing the player ('X' or 'O').
+     * @param depth Depth of the search tree, the pass counting as a ply.
+     * @return The score for the player, in the units of the scores of analyze.
+     */
+    int scorePosition(const std::vector<std::vector<char>> &board, char player, int depth);
+
+    /**
+     * @brief Returns the passes of the last MTD(f) search, iterative deepening included.
+     * @return The passes, in search order. Empty if the last search did not use MTD(f).
+     */
+    [[nodiscard]] const std::vector<MtdfPass> &getMtdfPasses() const { return mtdfPasses; }
+
+    /** @brief Returns the lookups of this Solver in its evaluation cache, over all its searches. */
+    [[nodiscard]] std::uint64_t getEvalCacheProbes() const { return evalCacheProbes; }
+
+    /** @brief Returns the successful lookups of this Solver in its evaluation cache, over all its searches. */
+    [[nodiscard]] std::uint64_t getEvalCacheHits() const { return evalCacheHits; }
+
     /**
      * @brief Determines the best move for a player on a given game board state.
      * @param board Current game board state represented as a 2D character std::vector.
@@ -33,19 +210,193 @@ class Solver {
      */
     static Position getBestMovePosition(const std::vector<std::vector<char>> &board, char player, int depth);
 
+    /**
+     * @brief Same as getBestMovePosition, returning the compact square index of the move.
+     * @param board Current game board state represented as a 2D character std::vector.
+     * @param player Character representing the player ('X' or 'O').
+     * @param depth Depth of the search tree.
+     * @return Square Best move for the player, NO_SQUARE if the player has no move.
+     */
+    static Square getBestMoveSquare(const std::vector<std::vector<char>> &board, char player, int depth);
+
+    /**
+     * @brief Starts a search in the background.
+     *
+     * The board is copied, so the caller may modify its own board while the search runs.
+     * @param board Current game board state represented as a 2D character std::vector.
+     * @param player Character representing the player ('X' or 'O').
+     * @param depth Depth of the search tree.
+     * @return SearchHandle Handle to stop the search, poll its best move so far or get its result.
+     */
+    static SearchHandle startSearch(const std::vector<std::vector<char>> &board, char player, int depth,
+                                    TranspositionTable *table = nullptr);
+
   private:
 
+    SearchContext &context;
+    TranspositionTable *table = nullptr;
+
+    const NnueNetwork *network = nullptr;
+    EvalCache *evalCache = nullptr;
+    AnalysisStore *store = nullptr;
+    SearchOptions options;
+
+    /** Trace of the visited nodes, nullptr when not recording. */
+    SearchTrace::Writer *trace = nullptr;
+    /** Ply of the node being searched, move leading to it, and how it got its score: only kept for the trace. */
+    int tracePly = 0;
+    Square lastMove = NO_SQUARE;
+    SearchTrace::Kind traceKind = SearchTrace::KIND_INTERIOR;
+    std::uint8_t traceCutoff = SearchTrace::NO_CUTOFF;
+    std::uint8_t traceMoveCount = 0;
+
+    /** Passes of the last MTD(f) search. */
+    std::vector<MtdfPass> mtdfPasses;
+
+    /** Lookups and hits in the evaluation cache, counted here rather than in the shared cache. */
+    std::uint64_t evalCacheProbes = 0;
+    std::uint64_t evalCacheHits = 0;
+
+    /** First layer output of the network for the node being searched, kept up to date by makeMove. */
+    NnueNetwork::Accumulator accumulator;
+
+    /** Zobrist hash of the pieces of the node being searched, kept up to date by makeMove. */
+    std::uint64_t pieceHash = 0;
+
+    /** Discs of X then O on the node being searched, kept up to date by makeMove. */
+    std::uint64_t discs[2] = {0, 0};
+
+    /** Key of the searching player, xored into every table key. */
+    std::uint64_t perspective = 0;
+
+    /**
+     * @brief Computes the hash, network accumulator and table perspective of a new root.
+     * @param node The root.
+     * @param player The searching player.
+     */
+    void setRoot(const std::vector<std::vector<char>> &node, char player);
+
+    /**
+     * @brief Searches the best move by MTD(f), without resetting the context, so that the node
+     * count adds up over the iterations of a deepening search.
+     * @param board Current game board state represented as a 2D character std::vector.
+     * @param player Character representing the player ('X' or 'O').
+     * @param depth Depth of the search tree.
+     * @param guess First estimate of the value, the score of the previous iteration if any.
+     * @param firstMove Root move searched first in every pass, NO_SQUARE for none.
+     * @return The best move and its score, empty if the player has no move or the context was
+     * stopped before a pass found a move. If stopped later, the move that made the last pass
+     * fail high and its lower bound.
+     */
+    std::vector<MoveAnalysis> mtdf(const std::vector<std::vector<char>> &board, char player, int depth, int guess,
+                                   Square firstMove);
+
+    /**
+     * @brief Returns the symmetries of a root worth looking for: those of the board with the
+     * hand-written evaluation, which scores boards equal by symmetry alike, none with a network.
+     * @param node The root.
+     * @param mover The player to move.
+     * @return The symmetries of the root as given by Bitboard::symmetries, 0 if not looked for.
+     */
+    [[nodiscard]] unsigned rootSymmetries(const std::vector<std::vector<char>> &node, char mover) const;
+
+    /**
+     * @brief Returns the node being searched as a bitboard.
+     * @param mover The player whose discs are Bitboard::player.
+     */
+    [[nodiscard]] Bitboard nodeBoard(char mover) const {
+        return mover == 'X' ? Bitboard(discs[0], discs[1]) : Bitboard(discs[1], discs[0]);
+    }
+
+    /**
+     * @brief Lists the legal moves of a player on the node being searched, in square order, with
+     * the move generation kernel of the CPU.
+     * @param mover The player to move.
+     * @param moves Receives the moves.
+     */
+    void generateMoves(char mover, MoveList &moves) const;
+
+    /**
+     * @brief Checks if neither player can move on the node being searched.
+     */
+    [[nodiscard]] bool isFinished() const;
+
+    /**
+     * @brief Plays a move on the searched node, with the flip kernel of the CPU, and updates its
+     * bitboards and hash.
+     */
+    void makeMove(std::vector<std::vector<char>> &node, Square move, char mover, MoveUndo &undo);
+
+    /**
+     * @brief Takes back a move played with makeMove and restores the bitboards and hash.
+     */
+    void unmakeMove(std::vector<std::vector<char>> &node, const MoveUndo &undo, char mover);
+
+    /**
+     * @brief Evaluates a leaf with the network, or the evaluation kernel of the CPU, through the
+     * evaluation cache.
+     * @param node The leaf.
+     * @param player The player whose point of view is wanted.
+     * @param finished true if neither player can move, scoring the leaf by its discs; only read
+     * with a network, the evaluation kernel scoring final positions by itself.
+     * @return The evaluation score.
+     */
+    int evaluate(const std::vector<std::vector<char>> &node, char player, bool finished);
+
+    /**
+     * @brief Computes the key of a node in the analysis store.
+     *
+     * With the hand-written evaluation, which gives the same score to boards equal by symmetry,
+     * the key is the one of the canonical board, so all 8 symmetric positions share their results.
+     * Scores are from the point of view of the searching player and the evaluation does not
+     * negate between the two players, so the key also tells if the searching player is to move.
+     * @param node The node.
+     * @param mover The player to move.
+     * @param searcherToMove true if the mover is the searching player.
+     * @param symmetry Receives the symmetry from the node to the stored board.
+     * @return The key.
+     */
+    std::uint64_t storeKey(const std::vector<std::vector<char>> &node, char mover, bool searcherToMove,
+                           int &symmetry) const;
+
+    /**
+     * @brief Follows the best moves stored in the transposition table from the current node.
+     * @param node Current game board state, left unchanged on return.
+     * @param toMove The player to move.
+     * @param maxLength Maximum number of moves to follow.
+     * @param pv Receives the moves, passes excluded.
+     */
+    void extractPv(std::vector<std::vector<char>> &node, char toMove, int maxLength, std::vector<Position> &pv);
+
+    /**
+     * @brief Records the end of a root search into the trace.
+     * @param depth Depth of the search.
+     * @param score Score of the best move.
+     * @param moveCount Number of root moves.
+     * @param nodes Nodes visited by the search.
+     */
+    void traceRoot(int depth, int score, int moveCount, unsigned long long nodes);
+
+    /**
+     * @brief Searches a node with alphaBetaNode, recording it into the trace if there is one.
+     * Same parameters and result as alphaBetaNode.
+     */
+    int miniMaxAlphaBeta(
+            std::vector<std::vector<char>> &node, char player, int depth, bool max, int alpha, int beta);
+
     /**
      * @brief Minimax algorithm with alpha-beta pruning to determine the best move score.
      *
-     * @param node Current game board state represented as a 2D character std::vector.
+     * @param node Current game board state represented as a 2D character std::vector. Moves are
+     * played and taken back in place, so it is left unchanged on return.
      * @param player Character representing the player ('X' or 'O').
      * @param depth Remaining depth of the search tree.
      * @param max Boolean flag indicating whether the function is maximizing or minimizing.
      * @param alpha Alpha value for alpha-beta pruning.
      * @param beta Beta value for alpha-beta pruning.
-     * @return int Score of the best move.
+     * @return int Score of the best move: exact inside (alpha, beta), an upper bound if at most
+     * alpha, a lower bound if at least beta. Meaningless if the context was stopped meanwhile.
      */
-    static int miniMaxAlphaBeta(
+    int alphaBetaNode(
             std::vector<std::vector<char>> &node, char player, int depth, bool max,int alpha, int beta);
 };
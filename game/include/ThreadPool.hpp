@@ -0,0 +1,131 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Set of tasks that can be waited for together.
+ */
+class TaskGroup {
+public:
+    TaskGroup() = default;
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    /**
+     * @brief Checks if every task of the group has run.
+     * @return true if no task of the group is queued or running, false otherwise.
+     */
+    [[nodiscard]] bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    std::atomic<int> pending{0};
+
+    friend class ThreadPool;
+};
+
+/**
+ * @brief Work-stealing thread pool.
+ *
+ * Every worker owns a queue. A worker pushes the tasks it submits at the back of its own queue
+ * and pops from the back (newest first, while the data is still in cache); idle workers steal
+ * from the front of the other queues (oldest first, usually the biggest tasks). Threads outside
+ * the pool submit to a shared queue.
+ *
+ * wait() runs queued tasks while the group is not done instead of blocking, so tasks may submit
+ * and wait for subtasks without ever deadlocking the pool.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Constructs a new Thread Pool.
+     * @param threadCount Number of workers. 0 uses the number of hardware threads.
+     */
+    explicit ThreadPool(unsigned int threadCount = 0);
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief Stops the workers, after the queued tasks have run.
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Queues a task.
+     * @param group The group the task belongs to. Must outlive the task.
+     * @param task The task.
+     */
+    void submit(TaskGroup &group, std::function<void()> task);
+
+    /**
+     * @brief Runs queued tasks until every task of the group has run. When none is left to run,
+     * spins briefly, then sleeps until the last task of the group ends.
+     * @param group The group to wait for.
+     */
+    void wait(TaskGroup &group);
+
+    /** @brief Returns the number of workers. */
+    [[nodiscard]] unsigned int size() const { return static_cast<unsigned int>(workers.size()); }
+
+private:
+    struct Task {
+        std::function<void()> function;
+        TaskGroup *group;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /** One queue per worker, then the shared queue of the threads outside the pool. */
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic<int> queuedTasks{0};
+    std::atomic<int> sleepingWaiters{0}; // threads asleep in wait, woken when a group ends
+    std::atomic<bool> stopping{false};
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+
+    /**
+     * @brief Returns the queue of the calling thread.
+     */
+    std::size_t ownQueue() const;
+
+    /**
+     * @brief Runs one queued task, from the own queue first, stolen otherwise.
+     * @param self Index of the queue of the calling thread.
+     * @return true if a task was run, false if every queue was empty.
+     */
+    bool runOne(std::size_t self);
+
+    /**
+     * @brief Main loop of a worker.
+     * @param self Index of the queue of the worker.
+     */
+    void workerLoop(std::size_t self);
+};
\ No newline at end of file
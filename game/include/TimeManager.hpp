@@ -0,0 +1,102 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "Position.hpp"
+#include <chrono>
+
+/**
+ * @brief Time control of a game: a total time per player plus an increment after every move.
+ */
+struct TimeControl {
+    /** @brief Time of a player for the whole game. */
+    std::chrono::milliseconds total{60000};
+    /** @brief Time added to the clock of a player after each of their moves. */
+    std::chrono::milliseconds increment{0};
+};
+
+/**
+ * @brief Clock of the AI player and allocation of its time to the moves.
+ *
+ * At the start of a move the remaining time is shared between the moves the player still has to
+ * play, about half of the empty squares, giving a soft budget; the hard limit is a few soft
+ * budgets, never more than the clock minus a reserve, so the player never runs out of time.
+ *
+ * The search deepens iteratively and asks shouldStartIteration before every iteration. The soft
+ * budget is stretched while the search is unstable, i.e. when the best move changed or the score
+ * swung in the last iteration, and shrunk when several iterations agree.
+ */
+class TimeManager {
+public:
+    /**
+     * @brief Constructs a new Time Manager, its clock set to the total time of the control.
+     * @param control The time control.
+     */
+    explicit TimeManager(const TimeControl &control);
+
+    /**
+     * @brief Starts the clock for a move and computes its budgets.
+     * @param empties Number of empty squares of the board.
+     */
+    void startMove(int empties);
+
+    /**
+     * @brief Stops the clock after a move: the time spent is taken from the clock, then the increment added.
+     */
+    void stopMove();
+
+    /**
+     * @brief Checks if there is time for one more, deeper, iteration.
+     * @return true if the search should go on.
+     */
+    [[nodiscard]] bool shouldStartIteration() const;
+
+    /**
+     * @brief Records the result of a completed iteration.
+     * @param score The score of the best move.
+     * @param bestMove The best move.
+     */
+    void iterationDone(int score, const Position &bestMove);
+
+    /** @brief Returns the time past which the search must abort. */
+    [[nodiscard]] std::chrono::steady_clock::time_point getHardDeadline() const { return start + hardLimit; }
+
+    /** @brief Returns the soft budget of the current move, before stability adjustments. */
+    [[nodiscard]] std::chrono::milliseconds getSoftBudget() const { return softBudget; }
+
+    /** @brief Returns the hard limit of the current move. */
+    [[nodiscard]] std::chrono::milliseconds getHardLimit() const { return hardLimit; }
+
+    /** @brief Returns the time spent on the current move so far. */
+    [[nodiscard]] std::chrono::milliseconds getElapsed() const;
+
+    /** @brief Returns the time left on the clock, not counting the current move. */
+    [[nodiscard]] std::chrono::milliseconds getRemaining() const { return remaining; }
+
+private:
+    TimeControl control;
+    std::chrono::milliseconds remaining;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::milliseconds softBudget{0};
+    std::chrono::milliseconds hardLimit{0};
+
+    /** Factor applied to the soft budget, above 1 while the search is unstable. */
+    double instability = 1.0;
+    int iterations = 0;
+    int lastScore = 0;
+    Position lastBestMove;
+};
\ No newline at end of file
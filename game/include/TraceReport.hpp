@@ -0,0 +1,42 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include <istream>
+#include <ostream>
+
+/**
+ * @brief Offline analysis of a SearchTrace file.
+ *
+ * Reports how the nodes got their scores, the distribution of the index of the move that cut
+ * off by remaining depth, which tells how well the moves are ordered, and the subtrees near the
+ * root that cost the most nodes, with the moves leading to them.
+ */
+class TraceReport {
+public:
+    /** @brief Deepest ply whose subtrees are ranked by cost. */
+    static constexpr int MAX_RANKED_PLY = 4;
+
+    /**
+     * @brief Reads a trace and prints its report.
+     * @param in Stream of the trace file.
+     * @param out Stream receiving the report.
+     * @param top Number of most expensive subtrees to list.
+     * @throws std::runtime_error if the stream is not a valid trace file.
+     */
+    static void run(std::istream &in, std::ostream &out, int top = 20);
+};
\ No newline at end of file
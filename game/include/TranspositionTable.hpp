@@ -0,0 +1,157 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+#pragma once
+
+#include "Move.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Random keys of the Zobrist hash, generated at compile time with splitmix64.
+ */
+namespace ZobristKeys {
+
+constexpr std::uint64_t splitMix(std::uint64_t &state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr std::array<std::array<std::uint64_t, 64>, 2> makePieceKeys() {
+    std::array<std::array<std::uint64_t, 64>, 2> keys{};
+    std::uint64_t state = 0x0123456789ABCDEFULL;
+    for (auto &side: keys)
+        for (auto &key: side)
+            key = splitMix(state);
+    return keys;
+}
+
+constexpr std::array<std::uint64_t, 4> makeSideKeys() {
+    std::array<std::uint64_t, 4> keys{};
+    std::uint64_t state = 0xFEDCBA9876543210ULL;
+    for (auto &key: keys)
+        key = splitMix(state);
+    return keys;
+}
+
+/** @brief Key of an X (index 0) or O (index 1) piece on each square. */
+inline constexpr std::array<std::array<std::uint64_t, 64>, 2> PIECES = makePieceKeys();
+
+/** @brief Side to move keys (X, O), then perspective keys (X, O). */
+inline constexpr std::array<std::uint64_t, 4> SIDES = makeSideKeys();
+
+} // namespace ZobristKeys
+
+/**
+ * @brief Hash table of search results, indexed by the Zobrist hash of a position.
+ *
+ * Each entry keeps the score of a subtree, the depth it was searched to, whether the score is
+ * exact or only a bound, and the best move found, which is tried first when the position is met
+ * again. The table can be kept between searches so that later searches reuse earlier results.
+ * A table must not be used by two searches at the same time.
+ */
+class TranspositionTable {
+public:
+    /** @brief How the stored score relates to the true score of the position. */
+    enum Bound : std::uint8_t { BOUND_NONE, BOUND_EXACT, BOUND_LOWER, BOUND_UPPER };
+
+    /** @brief One slot of the table. */
+    struct Entry {
+        std::uint64_t key = 0;
+        std::int32_t score = 0;
+        std::int8_t depth = 0;
+        Bound bound = BOUND_NONE;
+        Square bestMove = NO_SQUARE;
+        std::uint8_t generation = 0;
+    };
+
+    /**
+     * @brief Constructs a new Transposition Table.
+     * @param sizeInMegabytes Memory budget. The entry count is rounded down to a power of two.
+     */
+    explicit TranspositionTable(std::size_t sizeInMegabytes = 16);
+
+    /**
+     * @brief Looks up a position.
+     * @param key The hash of the position.
+     * @return The entry if the position is stored, nullptr otherwise.
+     */
+    [[nodiscard]] const Entry *probe(std::uint64_t key) const;
+
+    /**
+     * @brief Stores the result of a search. Entries of the current generation are only replaced
+     * by results searched at least as deep.
+     * @param key The hash of the position.
+     * @param depth The remaining depth the position was searched to.
+     * @param score The score found.
+     * @param bound Whether the score is exact, a lower bound or an upper bound.
+     * @param bestMove The best move found, NO_SQUARE if unknown.
+     */
+    void store(std::uint64_t key, int depth, int score, Bound bound, Square bestMove);
+
+    /**
+     * @brief Marks the start of a new search: entries of older searches become replaceable.
+     */
+    void newSearch() { generation++; }
+
+    /** @brief Empties the table. */
+    void clear();
+
+    /** @brief Returns the number of entries of the table. */
+    [[nodiscard]] std::size_t size() const { return entries.size(); }
+
+    /**
+     * @brief Returns the hash key of a piece on a square.
+     * @param square The square.
+     * @param piece The piece ('X' or 'O').
+     * @return The key to xor into the position hash.
+     */
+    static std::uint64_t pieceKey(Square square, char piece) {
+        return ZobristKeys::PIECES[piece == 'X' ? 0 : 1][square];
+    }
+
+    /**
+     * @brief Returns the hash key of the player to move.
+     * @param player The player ('X' or 'O').
+     * @return The key to xor into the position hash.
+     */
+    static std::uint64_t sideKey(char player) { return player == 'X' ? ZobristKeys::SIDES[0] : ZobristKeys::SIDES[1]; }
+
+    /**
+     * @brief Returns the hash key of the player whose point of view the stored scores are from.
+     *
+     * Solver scores positions from the point of view of the player it searches for, so the same
+     * position searched for X and for O must not share an entry.
+     * @param player The player ('X' or 'O').
+     * @return The key to xor into the position hash.
+     */
+    static std::uint64_t perspectiveKey(char player) { return player == 'X' ? ZobristKeys::SIDES[2] : ZobristKeys::SIDES[3]; }
+
+    /**
+     * @brief Computes the hash of the pieces of a board from scratch. The side key of the player
+     * to move still has to be xored in.
+     * @param board 2D char vector representing the board.
+     * @return The Zobrist hash of the pieces.
+     */
+    static std::uint64_t hash(const std::vector<std::vector<char>> &board);
+
+private:
+    std::vector<Entry> entries;
+    std::uint8_t generation = 0;
+};
\ No newline at end of file
@@ -0,0 +1,401 @@
+
+#include "../include/AnalysisCluster.hpp"
+#include "../include/Solver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+constexpr char EMPTY = '-';
+constexpr char PLAYER_X = 'X';
+constexpr char PLAYER_O = 'O';
+constexpr int BOARD_SIZE = 8;
+constexpr int POLL_INTERVAL_MS = 50; // also the resolution of the job time limit
+
+std::vector<AnalysisCluster::Position> AnalysisCluster::readPositions(std::istream &in) {
+    std::vector<Position> positions;
+    std::string line;
+    for (int number = 1; std::getline(in, line); number++) {
+        if (line.empty())
+            continue;
+        if (line.size() < BOARD_SIZE * BOARD_SIZE + 2)
+            throw std::runtime_error("line " + std::to_string(number) + ": expected \"<squares> <player>\"");
+        Position position{line.substr(0, BOARD_SIZE * BOARD_SIZE), line[BOARD_SIZE * BOARD_SIZE + 1]};
+        for (char &square: position.squares) {
+            if (square == '.')
+                square = EMPTY;
+            if (square != EMPTY && square != PLAYER_X && square != PLAYER_O)
+                throw std::runtime_error("line " + std::to_string(number) + ": invalid square '" + square + "'");
+        }
+        if (position.player != PLAYER_X && position.player != PLAYER_O)
+            throw std::runtime_error("line " + std::to_string(number) + ": invalid player");
+        positions.push_back(position);
+    }
+    return positions;
+}
+
+#if !defined(_WIN32)
+
+/** Sends a line, false if the peer is gone. */
+static bool sendLine(int fd, const std::string &line) {
+    std::string data = line + "\n";
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0)
+            return false;
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+/** Fills the address of a socket path, false if the path is too long. */
+static bool socketAddress(const std::string &path, sockaddr_un &address) {
+    address = sockaddr_un{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+        return false;
+    std::strcpy(address.sun_path, path.c_str());
+    return true;
+}
+
+/** Keeps a descriptor from leaking into the workers started later. */
+static int closeOnExec(int fd) {
+    if (fd >= 0)
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+}
+
+/** Returns the name of a move, e.g. "d3", or "pass". */
+static std::string moveName(Square move) {
+    if (move == NO_SQUARE)
+        return "pass";
+    return {static_cast<char>('a' + move % BOARD_SIZE), static_cast<char>('1' + move / BOARD_SIZE)};
+}
+
+/**
+ * One worker process, seen from the coordinator.
+ */
+struct WorkerSlot {
+    pid_t pid = -1;
+    int fd = -1;  // -1 until the worker said hello
+    int job = -1; // index of the position being analyzed, -1 if idle
+    std::chrono::steady_clock::time_point jobStart;
+};
+
+/** Starts a worker process, -1 if fork failed. */
+static pid_t spawnWorker(const ClusterOptions &options, const std::string &socketPath) {
+    std::vector<std::string> args = {options.executable, "worker", socketPath,
+                                     "--depth", std::to_string(options.depth),
+                                     "--tt-mb", std::to_string(options.tableMegabytes)};
+    std::vector<char *> argv;
+    for (std::string &arg: args)
+        argv.push_back(arg.data());
+    argv.push_back(nullptr);
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        ::execv(options.executable.c_str(), argv.data());
+        ::_exit(127);
+    }
+    return pid;
+}
+
+std::vector<ClusterResult> AnalysisCluster::runCoordinator(const std::vector<Position> &positions,
+                                                          const ClusterOptions &options, std::ostream &out) {
+    const std::string socketPath = options.socketPath.empty()
+                                   ? "/tmp/othello-cluster-" + std::to_string(::getpid()) + ".sock"
+                                   : options.socketPath;
+    sockaddr_un address{};
+    if (!socketAddress(socketPath, address))
+        throw std::runtime_error("socket path too long: " + socketPath);
+    int listenFd = closeOnExec(::socket(AF_UNIX, SOCK_STREAM, 0));
+    if (listenFd < 0)
+        throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    ::unlink(socketPath.c_str());
+    if (::bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || ::listen(listenFd, 128) < 0) {
+        std::string error = std::strerror(errno);
+        ::close(listenFd);
+        throw std::runtime_error("bind/listen " + socketPath + ": " + error);
+    }
+
+    unsigned int workerCount = options.workers > 0 ? options.workers : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<WorkerSlot> slots(workerCount);
+    std::map<int, std::string> inputs; // connections, by fd
+    std::map<int, int> owners;         // slot of each identified connection
+    std::vector<ClusterResult> results(positions.size());
+    std::vector<bool> settled(positions.size(), false); // done or failed
+    std::deque<int> queue;
+    for (int i = 0; i < static_cast<int>(positions.size()); i++)
+        queue.push_back(i);
+    std::size_t finished = 0, printed = 0;
+    int restarts = 0, lossesSinceResult = 0;
+    unsigned long long nodes = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    auto closeConnection = [&](int fd) {
+        ::close(fd);
+        inputs.erase(fd);
+        owners.erase(fd);
+    };
+    auto shutdown = [&]() {
+        // a worker started to replace a lost one may not have connected yet: it has nothing to finish
+        for (WorkerSlot &slot: slots) {
+            if (slot.fd >= 0)
+                sendLine(slot.fd, "quit");
+            else if (slot.pid > 0)
+                ::kill(slot.pid, SIGKILL);
+        }
+        for (WorkerSlot &slot: slots) {
+            if (slot.pid > 0)
+                ::waitpid(slot.pid, nullptr, 0);
+            slot.pid = -1;
+        }
+        while (!inputs.empty())
+            closeConnection(inputs.begin()->first);
+        ::close(listenFd);
+        ::unlink(socketPath.c_str());
+    };
+    // a lost worker gives its position back, or fails it after too many attempts, and is replaced
+    auto loseWorker = [&](WorkerSlot &slot) {
+        if (slot.fd >= 0)
+            closeConnection(slot.fd);
+        slot.fd = -1;
+        if (slot.pid > 0) {
+            ::kill(slot.pid, SIGKILL);
+            ::waitpid(slot.pid, nullptr, 0);
+        }
+        slot.pid = -1;
+        if (slot.job >= 0) {
+            if (results[slot.job].attempts >= options.maxAttempts) {
+                settled[slot.job] = true;
+                finished++;
+                lossesSinceResult = -1; // a failed position is settled too
+            } else {
+                queue.push_front(slot.job);
+            }
+            slot.job = -1;
+        }
+        lossesSinceResult++;
+        if (finished < positions.size()) {
+            restarts++;
+            slot.pid = spawnWorker(options, socketPath);
+        }
+    };
+
+    for (WorkerSlot &slot: slots)
+        slot.pid = spawnWorker(options, socketPath);
+
+    std::vector<pollfd> fds;
+    while (finished < positions.size()) {
+        // workers that keep dying without settling a position, e.g. a wrong executable, will never finish
+        if (lossesSinceResult > 3 * static_cast<int>(workerCount) + options.maxAttempts) {
+            shutdown();
+            throw std::runtime_error("workers keep failing, " + options.executable + " worker does not work");
+        }
+
+        fds.clear();
+        fds.push_back({listenFd, POLLIN, 0});
+        for (auto &[fd, input]: inputs)
+            fds.push_back({fd, POLLIN, 0});
+        int ready = ::poll(fds.data(), fds.size(), POLL_INTERVAL_MS);
+
+        // exited workers
+        int status;
+        pid_t exited;
+        while ((exited = ::waitpid(-1, &status, WNOHANG)) > 0) {
+            for (WorkerSlot &slot: slots) {
+                if (slot.pid == exited) {
+                    slot.pid = -1; // already reaped
+                    loseWorker(slot);
+                }
+            }
+        }
+
+        if (ready > 0 && (fds[0].revents & POLLIN)) {
+            int fd = closeOnExec(::accept(listenFd, nullptr, nullptr));
+            if (fd >= 0)
+                inputs[fd];
+        }
+        for (std::size_t i = 1; ready > 0 && i < fds.size(); i++) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR)) || !inputs.count(fds[i].fd))
+                continue; // nothing to read, or closed with its lost worker
+            int fd = fds[i].fd;
+            auto owner = owners.find(fd);
+            char buffer[4096];
+            // never blocks: the fd may have been closed with a lost worker and reused by accept since the poll
+            ssize_t n = ::recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+                continue;
+            if (n <= 0) {
+                if (owner != owners.end())
+                    loseWorker(slots[owner->second]);
+                else
+                    closeConnection(fd);
+                continue;
+            }
+            std::string &input = inputs[fd];
+            input.append(buffer, static_cast<std::size_t>(n));
+            std::size_t end;
+            while ((end = input.find('\n')) != std::string::npos) {
+                std::istringstream words(input.substr(0, end));
+                input.erase(0, end + 1);
+                std::string command;
+                words >> command;
+                if (command == "hello") {
+                    pid_t pid = 0;
+                    words >> pid;
+                    for (int s = 0; s < static_cast<int>(slots.size()); s++) {
+                        if (slots[s].pid == pid && slots[s].fd < 0) {
+                            slots[s].fd = fd;
+                            owners[fd] = s;
+                        }
+                    }
+                } else if (command == "result" && owners.count(fd)) {
+                    WorkerSlot &slot = slots[owners[fd]];
+                    int id = -1, move = NO_SQUARE, score = 0;
+                    unsigned long long jobNodes = 0;
+                    words >> id >> move >> score >> jobNodes;
+                    if (!words || id != slot.job)
+                        continue; // not the position it was given: ignored, the position stays assigned
+                    ClusterResult &result = results[id];
+                    result.done = true;
+                    result.move = static_cast<Square>(move);
+                    result.score = score;
+                    result.nodes = jobNodes;
+                    nodes += jobNodes;
+                    settled[id] = true;
+                    finished++;
+                    slot.job = -1;
+                    lossesSinceResult = 0;
+                }
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        for (WorkerSlot &slot: slots) {
+            if (options.jobTimeoutMs > 0 && slot.job >= 0 &&
+                now - slot.jobStart > std::chrono::milliseconds(options.jobTimeoutMs))
+                loseWorker(slot);
+            if (slot.fd < 0 || slot.job >= 0 || queue.empty())
+                continue;
+            slot.job = queue.front();
+            queue.pop_front();
+            results[slot.job].attempts++;
+            slot.jobStart = now;
+            const Position &position = positions[slot.job];
+            if (!sendLine(slot.fd, "job " + std::to_string(slot.job) + " " + position.squares + " " + position.player))
+                loseWorker(slot);
+        }
+
+        // stream the results in order
+        for (; printed < positions.size() && settled[printed]; printed++) {
+            const ClusterResult &result = results[printed];
+            out << "#" << std::setw(4) << printed + 1 << ": ";
+            if (result.done)
+                out << "move " << std::setw(4) << moveName(result.move) << "  score " << std::showpos << std::setw(7)
+                    << result.score << std::noshowpos << "  nodes " << std::setw(10) << result.nodes << std::endl;
+            else
+                out << "failed, lost " << result.attempts << " workers" << std::endl;
+        }
+    }
+    shutdown();
+
+    int failed = 0;
+    for (const ClusterResult &result: results)
+        failed += result.done ? 0 : 1;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    out << "==========================" << std::endl;
+    out << "workers   : " << workerCount << std::endl;
+    out << "positions : " << positions.size() << std::endl;
+    out << "failed    : " << failed << std::endl;
+    out << "restarts  : " << restarts << std::endl;
+    out << "nodes     : " << nodes << std::endl;
+    out << "time (s)  : " << std::fixed << std::setprecision(3) << seconds << std::defaultfloat << std::endl;
+    return results;
+}
+
+int AnalysisCluster::runWorker(const std::string &socketPath, int depth, std::size_t tableMegabytes) {
+    sockaddr_un address{};
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || !socketAddress(socketPath, address) ||
+        ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+        !sendLine(fd, "hello " + std::to_string(::getpid()))) {
+        if (fd >= 0)
+            ::close(fd);
+        return 1;
+    }
+
+    // one table for all the positions of this worker: positions of the same game share results
+    TranspositionTable table(tableMegabytes);
+    SearchContext context;
+    Solver solver(context, &table);
+    std::vector<std::vector<char>> board(BOARD_SIZE, std::vector<char>(BOARD_SIZE));
+    std::string input;
+    while (true) {
+        std::size_t end;
+        while ((end = input.find('\n')) == std::string::npos) {
+            char buffer[4096];
+            ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) {
+                ::close(fd);
+                return 1; // coordinator gone
+            }
+            input.append(buffer, static_cast<std::size_t>(n));
+        }
+        std::istringstream words(input.substr(0, end));
+        input.erase(0, end + 1);
+        std::string command;
+        words >> command;
+        if (command == "quit")
+            break;
+        int id;
+        std::string squares;
+        char player;
+        if (command != "job" || !(words >> id >> squares >> player) || squares.size() != BOARD_SIZE * BOARD_SIZE)
+            continue;
+        for (int square = 0; square < BOARD_SIZE * BOARD_SIZE; square++)
+            board[square / BOARD_SIZE][square % BOARD_SIZE] = squares[square];
+        std::vector<MoveAnalysis> best = solver.analyze(board, player, depth, 1);
+        Square move = best.empty() ? NO_SQUARE : toSquare(best.front().move);
+        // a pass is scored by the search after it, or by the discs if the game is over
+        int score = best.empty() ? solver.scorePosition(board, player, depth) : best.front().score;
+        std::ostringstream result;
+        result << "result " << id << " " << static_cast<int>(move) << " " << score << " " << context.getNodeCount();
+        if (!sendLine(fd, result.str())) {
+            ::close(fd);
+            return 1;
+        }
+    }
+    ::close(fd);
+    return 0;
+}
+
+#else
+
+std::vector<ClusterResult> AnalysisCluster::runCoordinator(const std::vector<Position> &, const ClusterOptions &,
+                                                          std::ostream &) {
+    throw std::runtime_error("distributed analysis needs Unix domain sockets, which this platform does not provide");
+}
+
+int AnalysisCluster::runWorker(const std::string &, int, std::size_t) {
+    std::cerr << "Workers need Unix domain sockets, which this platform does not provide." << std::endl;
+    return 1;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,167 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/AnalysisStore.hpp"
+#include <cstring>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+constexpr char STORE_MAGIC[8] = {'O', 'T', 'H', 'S', 'T', 'O', 'R', '1'};
+constexpr std::size_t HEADER_BYTES = 64; // one cache line, the buckets after it stay aligned
+constexpr int AGE_PENALTY = 2;           // plies of depth an entry loses per generation unused
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "slots are shared between processes");
+
+/** Fields of a slot's data word. Bound is never BOUND_NONE in a stored slot, so data is never 0. */
+static int unpackScore(std::uint64_t data) { return static_cast<std::int32_t>(data & 0xFFFFFFFFULL); }
+static int unpackDepth(std::uint64_t data) { return static_cast<int>((data >> 32) & 0xFF); }
+static int unpackBound(std::uint64_t data) { return static_cast<int>((data >> 40) & 0x3); }
+static Square unpackMove(std::uint64_t data) { return static_cast<Square>((data >> 42) & 0x7F); }
+static std::uint8_t unpackGeneration(std::uint64_t data) { return static_cast<std::uint8_t>(data >> 49); }
+
+#if !defined(_WIN32)
+
+AnalysisStore::AnalysisStore(const std::string &path, std::size_t sizeInMegabytes) {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        throw std::runtime_error(path + ": " + std::strerror(errno));
+    // processes opening the file together must not both initialize it
+    ::flock(fd, LOCK_EX);
+    struct stat status{};
+    ::fstat(fd, &status);
+    std::size_t bucketBytes = BUCKET_SIZE * sizeof(Slot);
+    bool created = status.st_size == 0;
+    std::size_t bucketCount = 1;
+    if (created) {
+        while (bucketCount * 2 * bucketBytes <= sizeInMegabytes * 1024 * 1024)
+            bucketCount *= 2;
+        mappingSize = HEADER_BYTES + bucketCount * bucketBytes;
+        if (::ftruncate(fd, static_cast<off_t>(mappingSize)) != 0) {
+            std::string error = std::strerror(errno);
+            ::close(fd);
+            throw std::runtime_error(path + ": " + error);
+        }
+    } else {
+        mappingSize = static_cast<std::size_t>(status.st_size);
+    }
+    mapping = ::mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        std::string error = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error(path + ": " + error);
+    }
+
+    auto *header = static_cast<Header *>(mapping);
+    if (created) {
+        std::memcpy(header->magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+        header->bucketCount = bucketCount;
+    } else {
+        bucketCount = header->bucketCount;
+        bool valid = mappingSize >= HEADER_BYTES &&
+                     std::memcmp(header->magic, STORE_MAGIC, sizeof(STORE_MAGIC)) == 0 && bucketCount > 0 &&
+                     (bucketCount & (bucketCount - 1)) == 0 && mappingSize == HEADER_BYTES + bucketCount * bucketBytes;
+        if (!valid) {
+            ::munmap(mapping, mappingSize);
+            ::close(fd);
+            throw std::runtime_error(path + ": not an analysis store");
+        }
+    }
+    generation = static_cast<std::uint8_t>(header->generation.fetch_add(1, std::memory_order_relaxed) + 1);
+    ::flock(fd, LOCK_UN);
+
+    slots = reinterpret_cast<Slot *>(static_cast<char *>(mapping) + HEADER_BYTES);
+    bucketMask = bucketCount - 1;
+}
+
+AnalysisStore::~AnalysisStore() {
+    ::munmap(mapping, mappingSize);
+    ::close(fd);
+}
+
+#else
+
+AnalysisStore::AnalysisStore(const std::string &path, std::size_t) {
+    throw std::runtime_error(path + ": analysis stores are not supported on this system");
+}
+
+AnalysisStore::~AnalysisStore() = default;
+
+#endif
+
+std::uint64_t AnalysisStore::pack(const Entry &entry) const {
+    return static_cast<std::uint32_t>(entry.score) | static_cast<std::uint64_t>(entry.depth & 0xFF) << 32 |
+           static_cast<std::uint64_t>(entry.bound) << 40 | static_cast<std::uint64_t>(entry.bestMove) << 42 |
+           static_cast<std::uint64_t>(generation) << 49;
+}
+
+bool AnalysisStore::probe(std::uint64_t key, Entry &entry) {
+    probes.fetch_add(1, std::memory_order_relaxed);
+    Slot *bucket = slots + (key & bucketMask) * BUCKET_SIZE;
+    for (std::size_t i = 0; i < BUCKET_SIZE; i++) {
+        std::uint64_t data = bucket[i].data.load(std::memory_order_relaxed);
+        std::uint64_t check = bucket[i].check.load(std::memory_order_relaxed);
+        if (data == 0 || (check ^ data) != key)
+            continue;
+        entry.score = unpackScore(data);
+        entry.depth = unpackDepth(data);
+        entry.bound = static_cast<TranspositionTable::Bound>(unpackBound(data));
+        entry.bestMove = unpackMove(data);
+        if (unpackGeneration(data) != generation) {
+            // reached again: the slot ages from now on
+            std::uint64_t refreshed = pack(entry);
+            bucket[i].data.store(refreshed, std::memory_order_relaxed);
+            bucket[i].check.store(key ^ refreshed, std::memory_order_relaxed);
+        }
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void AnalysisStore::store(std::uint64_t key, const Entry &entry) {
+    Slot *bucket = slots + (key & bucketMask) * BUCKET_SIZE;
+    Slot *victim = nullptr;
+    int victimWorth = 0;
+    for (std::size_t i = 0; i < BUCKET_SIZE; i++) {
+        std::uint64_t data = bucket[i].data.load(std::memory_order_relaxed);
+        std::uint64_t check = bucket[i].check.load(std::memory_order_relaxed);
+        if (data != 0 && (check ^ data) == key) {
+            if (entry.depth < unpackDepth(data))
+                return; // the stored result is deeper
+            victim = &bucket[i];
+            break;
+        }
+        // an empty slot is worth nothing, an old one is worth its depth minus its age
+        int age = static_cast<std::uint8_t>(generation - unpackGeneration(data));
+        int worth = data == 0 ? -1024 : unpackDepth(data) - AGE_PENALTY * age;
+        if (!victim || worth < victimWorth) {
+            victim = &bucket[i];
+            victimWorth = worth;
+        }
+    }
+    std::uint64_t data = pack(entry);
+    victim->data.store(data, std::memory_order_relaxed);
+    victim->check.store(key ^ data, std::memory_order_relaxed);
+    stores.fetch_add(1, std::memory_order_relaxed);
+}
\ No newline at end of file
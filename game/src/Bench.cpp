@@ -0,0 +1,234 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/Bench.hpp"
+#include "../include/Evaluator.hpp"
+#include "../include/Solver.hpp"
+#include "../include/ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <random>
+
+constexpr char PLAYER_X = 'X';
+constexpr int BOARD_SIZE = 8;
+constexpr std::size_t BENCH_TABLE_MEGABYTES = 16;
+
+/** A benchmark position: the 64 squares row by row, then the player to move. */
+struct BenchPosition {
+    const char *squares;
+    char player;
+};
+
+/** Positions from random games, from the opening (ply 6) to the endgame (ply 53). */
+constexpr BenchPosition POSITIONS[] = {
+        {"------------O-------O-----OOO-----XXXX--------X-----------------", 'X'},
+        {"--------------------X-----OXX----OOOX-------OX------------------", 'X'},
+        {"--------------------X-----OOX----XOXX----OOX--------------------", 'O'},
+        {"--------------------X-----OXX-----XOOO-----XXO--------O---------", 'X'},
+        {"------------------XXXO-----XO-----XXXO-------X-------OX---------", 'O'},
+        {"----X-------X------OX------XO------XOOOO--XX-----X--------------", 'X'},
+        {"----O------O-O------OXO----XXX-----XXX-----XX-X-----------------", 'O'},
+        {"-----------O-------O-----XOXX----OXOXX---OOOO-----X-------------", 'X'},
+        {"-----------------X--XX----XOXX----OXXXX--OOOO--------O----------", 'O'},
+        {"-X----X---XOXX----XOX-----XOO-----OOOO----O-------O-------------", 'X'},
+        {"------X-----OXO---XXXX----XXOX-X--XXXXX------X------------------", 'O'},
+        {"-XO------OOO--X----XOX-----XX-----XXOXX---X-X-----X--X----------", 'X'},
+        {"----------XO-------OX----OXXXX----OXOXX----OXX----OOOX----------", 'O'},
+        {"----------X-X-----XX-X----XXX------OX-O----OXO-----OOXX--OOO--O-", 'X'},
+        {"---O-X------XOX--XXXXXXX--XOXXX---OOX----XXX--------------------", 'O'},
+        {"-----O-O--X--OO----XOO-----OOXO---OOXXOO-OOX-X---O------O-------", 'X'},
+        {"----------OX-----XOXXXX---OXOO---OOXOXX---X-XXX--X--X-X---------", 'O'},
+        {"------------X-O----OOO-X--OOO-X----OOOX----OX-X---XXX-XO--XXXX--", 'X'},
+        {"------------OOO---XO-XO---OOOX----OOXX--XXO-XXX---X-X-X---OX---X", 'O'},
+        {"-------------O------XO----OOXOX----OOXOX--XOOO-O-X-XOOO----XXXXO", 'X'},
+        {"---O--------OOO---O-OOOO--OOOXO---OOOXXX--OOXXXX--OX-X----------", 'O'},
+        {"-O-XO-O---OO-O--O-OXO----O-OXX--XXOXX---OOOOX------XOO------XO--", 'X'},
+        {"------O-------O---X-XXO--XXXXOX---XOOOOX--OXXOX---O-XXXO----XO-X", 'O'},
+        {"------X--O--XXX--OOXOX---OOOXO---XOOOOOOX--OOOO-----OXOX------X-", 'X'},
+        {"--X-----XOOOO----O-XXXO--OXXXX----OXOX---XXXXOX--XXXO--X---X-O--", 'O'},
+        {"--X--O----XXXO-O--XOXX-O--OXXOXO-OOOOXO--OOO-OXX--O-OX---O------", 'X'},
+        {"-----X------OOXO-OOOOOOX--OXOOO--OXOO----XOOOO--XXXOX---XXO-----", 'X'},
+        {"-X--X----X-OXXX-XXOXXXXX-OXOXOX-OOOOOOO---O-OXX---XOX-----------", 'O'},
+        {"--------OXXXXX--OOXOOX---OOOX-X--OOOX---O-XOOOO-OXOO-O--XXO---O-", 'X'},
+        {"---O----X-XOO----X-X-O--OXOXX-O--OOOOOO-OXXXXX--XXXXXX--XO-XXX--", 'O'},
+        {"--O------XXXXXXX-XXXOXX--OXOXOX-OOOXXOX--OOOOOXX-X--OO-O--------", 'X'},
+        {"---O----XOOO--O--OOOOOO-OOXXXXO--OXXXXX--XXXXX---OOOXOX---O-O-O-", 'O'},
+        {"--O--OX--OOOOXO--OOOOO-O-XXOOOOO-XXOXXOO----OOO-----OOXX----OXXX", 'X'},
+        {"XX-O-XX-OXXOOX---OXXOXX-OOXXXX--OOOXXOO-XXXXXX---X---OX------XO-", 'O'},
+        {"XX--O----XXOO-----OXOXOOOOOOOXO-OXOXOX--OOOXOXX-OOOOO---OX-XO---", 'X'},
+        {"-----XO----OXOOX---XOOOX--XXXXXX--OXXOXXXOOXXXXXOX-OOXX-OX-XO-X-", 'O'},
+        {"-O-O-X--XXOXX---XXXXOOOOOXXOXXO-OXXXXOO--OXXXO--OOXXX-X---XXX---", 'X'},
+        {"OO-X-OX-OOOXOX-XOOOOOOXOOOOOOXOO---XXOO---XXXXOO-----XXO----OXXX", 'O'},
+        {"-O-XXXXX--OOOOOX--OXOXOXXXOXOOOX-XOXXOOX-XOXX-OX--X--X-XOOO----X", 'X'},
+        {"X-OX--X-OXOXOOO--OXXO---OXXOOO---XXOOO--XOXOOOO-OXXXXOOXOXXXX-O-", 'O'},
+        {"XXXXOOXXXXXOOOOXOXOOXXOXOXOOOXXXOOXOXOXXO-O-O-O--OX---XO--------", 'X'},
+        {"--O-OOOO---OXXXOX---OXXOXOOOOOXOX--OOXOOXXXXOO-O-XXXOOOO-XXXXX-O", 'O'},
+        {"-----OO--O--OOOOXOOOXOXXOOOOOOXX-OXOOOX-XOXOXXXOXOOXX-XOXOOOOO--", 'X'},
+        {"-OOOOX--OOOOO--OXXXXXOOXXXOXXOO-XOXOX---XXXXOX--XXOOOOX-XOOOOO-X", 'O'},
+        {"XOOOOOOOOOOXXX---OXXXX-XOOOXXXX-OOXOXX--OOOXXOOOOOOXXXOO---OX--O", 'X'},
+        {"-XO--XXXXXXXXXXX-XOXXXOX-OXOOOOXO-OXOXO-OOOOOO-OXXOXXXX--O-OOOOO", 'O'},
+        {"-OOOOXX--XXXOXXXXX-OXOXXXXOXOXOX-OXXXOOOOXOXOXOOXXXXXO----XXOOO-", 'X'},
+        {"OOOOOOO--OXXOXX-OOXOXXXXOOXOXXXXOOOXXXXXOOXXXXXX--OOXXXX---O-XXX", 'O'},
+        {"OOO-OXXX-XOOOXXX-XOXOXXXOOOOXOXXOOOXOXXXOOXXXOXX-OOXXXO-OOOOX---", 'X'},
+        {"--XXXXXXXXXXXXOOXXXXXOOOXXXXXOOXXOOOOXX-OOOXXOXXOOO-X-X-OOOOOX-O", 'O'},
+};
+
+int Bench::positionCount() {
+    return static_cast<int>(sizeof(POSITIONS) / sizeof(POSITIONS[0]));
+}
+
+BenchResult Bench::run(int depth, std::ostream &out, const SearchOptions &options, SearchTrace *trace,
+                       std::size_t evalCacheMegabytes) {
+    BenchResult result;
+    result.signature = 0xCBF29CE484222325ULL; // FNV-1a offset basis
+    auto mix = [&result](std::uint64_t value) {
+        for (int i = 0; i < 8; i++) {
+            result.signature ^= (value >> (8 * i)) & 0xFF;
+            result.signature *= 0x100000001B3ULL; // FNV-1a prime
+        }
+    };
+
+    TranspositionTable table(BENCH_TABLE_MEGABYTES);
+    std::unique_ptr<EvalCache> evalCache;
+    if (evalCacheMegabytes > 0)
+        evalCache = std::make_unique<EvalCache>(evalCacheMegabytes);
+    std::unique_ptr<SearchTrace::Writer> traceWriter;
+    if (trace)
+        traceWriter = std::make_unique<SearchTrace::Writer>(*trace);
+    for (int i = 0; i < positionCount(); i++) {
+        std::vector<std::vector<char>> board(BOARD_SIZE, std::vector<char>(BOARD_SIZE));
+        for (int square = 0; square < BOARD_SIZE * BOARD_SIZE; square++)
+            board[square / BOARD_SIZE][square % BOARD_SIZE] = POSITIONS[i].squares[square];
+
+        table.clear();
+        if (evalCache)
+            evalCache->clear();
+        SearchContext context;
+        Solver solver(context, &table, nullptr, evalCache.get());
+        solver.setOptions(options);
+        solver.setTrace(traceWriter.get());
+        auto start = std::chrono::steady_clock::now();
+        Square best = solver.searchSquare(board, POSITIONS[i].player, depth);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        unsigned long long nodes = context.getNodeCount();
+        result.nodes += nodes;
+        result.seconds += seconds;
+        result.evalCacheProbes += solver.getEvalCacheProbes();
+        result.evalCacheHits += solver.getEvalCacheHits();
+        mix(nodes);
+        mix(best);
+        out << "position " << std::setw(2) << i + 1 << ": nodes " << std::setw(10) << nodes << "  best "
+            << toPosition(best) << "  " << std::fixed << std::setprecision(1) << seconds * 1000 << " ms"
+            << std::defaultfloat << std::endl;
+        if (!solver.getMtdfPasses().empty()) {
+            const std::vector<MtdfPass> &passes = solver.getMtdfPasses();
+            out << "    passes:";
+            for (const MtdfPass &pass: passes)
+                if (pass.depth == passes.back().depth)
+                    out << " " << (pass.score >= pass.beta ? ">=" : "<") << pass.beta << " " << pass.nodes;
+            out << "  (" << passes.size() << " over all depths)" << std::endl;
+        }
+    }
+
+    out << "==========================" << std::endl;
+    out << "depth     : " << depth << (options.mtdf ? " (MTD(f))" : "") << std::endl;
+    out << "nodes     : " << result.nodes << std::endl;
+    out << "time (s)  : " << std::fixed << std::setprecision(3) << result.seconds << std::defaultfloat << std::endl;
+    out << "nps       : " << static_cast<unsigned long long>(result.nodes / (result.seconds > 0 ? result.seconds : 1))
+        << std::endl;
+    if (evalCache)
+        out << "eval hits : " << std::fixed << std::setprecision(1)
+            << 100.0 * static_cast<double>(result.evalCacheHits) /
+                       static_cast<double>(std::max<std::uint64_t>(result.evalCacheProbes, 1))
+            << "% of " << result.evalCacheProbes << " lookups" << std::defaultfloat << std::endl;
+    out << "signature : " << std::hex << std::setw(16) << std::setfill('0') << result.signature << std::dec
+        << std::setfill(' ') << std::endl;
+    return result;
+}
+
+/**
+ * Positions of random games, each seen from both sides, with the final positions of the games.
+ */
+static std::vector<Bitboard> randomPositions(std::size_t count) {
+    std::vector<std::vector<char>> initialBoard;
+    BoardHelper::initBoard(initialBoard);
+    const Bitboard initial = Bitboard::fromBoard(initialBoard, PLAYER_X);
+
+    std::vector<Bitboard> positions;
+    positions.reserve(count + 1);
+    std::mt19937_64 random(1);
+    Bitboard board = initial;
+    while (positions.size() < count) {
+        positions.push_back(board);
+        positions.emplace_back(board.opponent, board.player);
+        std::uint64_t moves = board.getMoves();
+        if (!moves) {
+            board.pass();
+            if (!board.getMoves())
+                board = initial; // game over
+            continue;
+        }
+        for (int n = static_cast<int>(random() % Bitboard::popCount(moves)); n > 0; n--)
+            moves &= moves - 1;
+        Square move = Bitboard::firstSquare(moves);
+        board.play(move, board.getFlips(move));
+    }
+    positions.resize(count);
+    return positions;
+}
+
+std::size_t Bench::runEvaluation(std::size_t positions, unsigned int threads, std::ostream &out) {
+    std::vector<Bitboard> boards = randomPositions(positions);
+    std::vector<std::vector<std::vector<char>>> charBoards(boards.size());
+    for (std::size_t i = 0; i < boards.size(); i++)
+        boards[i].toBoard(charBoards[i], PLAYER_X);
+
+    std::vector<int> single(boards.size());
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < boards.size(); i++)
+        single[i] = Evaluator::getEvaluation(charBoards[i], PLAYER_X);
+    double singleSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::unique_ptr<ThreadPool> pool;
+    if (threads > 1)
+        pool = std::make_unique<ThreadPool>(threads);
+    std::vector<int> batch(boards.size());
+    start = std::chrono::steady_clock::now();
+    Evaluator::getEvaluations(boards.data(), boards.size(), batch.data(), pool.get());
+    double batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i < boards.size(); i++)
+        mismatches += single[i] != batch[i] ? 1 : 0;
+
+    auto rate = [](std::size_t count, double seconds) {
+        return static_cast<unsigned long long>(static_cast<double>(count) / (seconds > 0 ? seconds : 1));
+    };
+    out << "positions : " << boards.size() << std::endl;
+    out << "threads   : " << (threads > 1 ? threads : 1) << std::endl;
+    out << std::fixed << std::setprecision(3);
+    out << "single (s): " << singleSeconds << "  (" << rate(boards.size(), singleSeconds) << " per second)"
+        << std::endl;
+    out << "batch (s) : " << batchSeconds << "  (" << rate(boards.size(), batchSeconds) << " per second)"
+        << std::endl;
+    out << std::defaultfloat;
+    out << "mismatches: " << mismatches << std::endl;
+    return mismatches;
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/Bitboard.hpp"
+
+constexpr char EMPTY = '-';
+constexpr char PLAYER_X = 'X';
+constexpr char PLAYER_O = 'O';
+constexpr int BOARD_SIZE = 8;
+
+Bitboard Bitboard::fromBoard(const std::vector<std::vector<char>> &board, char player) {
+    Bitboard result;
+    for (int row = 0; row < BOARD_SIZE; row++) {
+        for (int col = 0; col < BOARD_SIZE; col++) {
+            std::uint64_t bit = 1ULL << (row * BOARD_SIZE + col);
+            if (board[row][col] == player)
+                result.player |= bit;
+            else if (board[row][col] != EMPTY)
+                result.opponent |= bit;
+        }
+    }
+    return result;
+}
+
+void Bitboard::toBoard(std::vector<std::vector<char>> &board, char player) const {
+    char oPlayer = (player == PLAYER_X) ? PLAYER_O : PLAYER_X;
+    board.assign(BOARD_SIZE, std::vector<char>(BOARD_SIZE, EMPTY));
+    for (int square = 0; square < BOARD_SIZE * BOARD_SIZE; square++) {
+        std::uint64_t bit = 1ULL << square;
+        if (this->player & bit)
+            board[square / BOARD_SIZE][square % BOARD_SIZE] = player;
+        else if (opponent & bit)
+            board[square / BOARD_SIZE][square % BOARD_SIZE] = oPlayer;
+    }
+}
+
+int Bitboard::getFinalScore() const {
+    int playerCount = popCount(player);
+    int opponentCount = popCount(opponent);
+    int empties = 64 - playerCount - opponentCount;
+    int diff = playerCount - opponentCount;
+    if (diff > 0)
+        return diff + empties;
+    if (diff < 0)
+        return diff - empties;
+    return 0;
+}
+
+/** Mirrors the columns: column c goes to column 7 - c. */
+static inline std::uint64_t mirrorColumns(std::uint64_t x) {
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    return ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+}
+
+/** Mirrors the rows: row r goes to row 7 - r. */
+static inline std::uint64_t mirrorRows(std::uint64_t x) {
+    x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+    x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+    return (x >> 32) | (x << 32);
+}
+
+/** Swaps rows and columns: square (r, c) goes to (c, r). */
+static inline std::uint64_t transpose(std::uint64_t x) {
+    std::uint64_t t;
+    t = 0x0F0F0F0F00000000ULL & (x ^ (x << 28));
+    x ^= t ^ (t >> 28);
+    t = 0x3333000033330000ULL & (x ^ (x << 14));
+    x ^= t ^ (t >> 14);
+    t = 0x5500550055005500ULL & (x ^ (x << 7));
+    x ^= t ^ (t >> 7);
+    return x;
+}
+
+std::uint64_t Bitboard::transform(std::uint64_t mask, int symmetry) {
+    if (symmetry & 1)
+        mask = mirrorColumns(mask);
+    if (symmetry & 2)
+        mask = mirrorRows(mask);
+    if (symmetry & 4)
+        mask = transpose(mask);
+    return mask;
+}
+
+Bitboard Bitboard::canonical() const {
+    return transformed(canonicalSymmetry());
+}
+
+int Bitboard::canonicalSymmetry() const {
+    Bitboard best = *this;
+    int bestSymmetry = 0;
+    for (int symmetry = 1; symmetry < SYMMETRY_COUNT; symmetry++) {
+        Bitboard candidate = transformed(symmetry);
+        if (candidate < best) {
+            best = candidate;
+            bestSymmetry = symmetry;
+        }
+    }
+    return bestSymmetry;
+}
+
+unsigned Bitboard::symmetries() const {
+    unsigned mask = 0;
+    for (int symmetry = 1; symmetry < SYMMETRY_COUNT; symmetry++) {
+        if (transformed(symmetry) == *this)
+            mask |= 1u << symmetry;
+    }
+    return mask;
+}
\ No newline at end of file
@@ -16,6 +16,8 @@
  */
 
 #include "../include/BoardHelper.hpp"
+#include "../include/Profiler.hpp"
+#include "../include/RayTables.hpp"
 
 const char EMPTY = '-';
 const char PLAYER_X = 'X';
@@ -44,81 +46,112 @@ void BoardHelper::printBoard(const std::vector<std::vector<char>> &board) {
     }
 }
 
+/**
+ * Walks a precomputed ray from the played square: the move reverses pieces in this direction if the
+ * ray holds at least one opponent piece immediately followed by a piece of the player. Returns the
+ * number of pieces to reverse, 0 if none.
+ */
+static inline int countRayFlips(const std::vector<std::vector<char>> &board, const RayTables::Ray &ray,
+                                char player) {
+    for (int k = 0; k < ray.length; k++) {
+        char cell = board[ray.squares[k] / BOARD_SIZE][ray.squares[k] % BOARD_SIZE];
+        if (cell == EMPTY)
+            return 0; // Exit if the cell is empty
+        if (cell == player)
+            return k; // Pieces between the played square and this one are reversed
+    }
+    return 0; // Reached the edge of the board
+}
+
+/**
+ * Cheap pre-check for move generation: a square can only be a move if one of its neighbors holds
+ * an opponent piece.
+ */
+static inline bool hasOpponentNeighbor(const std::vector<std::vector<char>> &board, unsigned int row,
+                                       unsigned int col, char player) {
+    const RayTables::SquareRays &entry = RayTables::SQUARES[row * BOARD_SIZE + col];
+    for (int i = 0; i < entry.neighborCount; i++) {
+        char cell = board[entry.neighbors[i] / BOARD_SIZE][entry.neighbors[i] % BOARD_SIZE];
+        if (cell != EMPTY && cell != player)
+            return true;
+    }
+    return false;
+}
+
 bool BoardHelper::isReversible(const std::vector<std::vector<char>> &board, const Position &pos, char player) {
-    // Check the eight directions around the cell
-    for (int row = -1; row <= 1; row++) {
-        for (int col = -1; col <= 1; col++) {
-            if (row == 0 && col == 0)
-                continue; // Ignore the current cell
-            int k = 1;
-            while (true) {
-                int newRow = (int) pos.row + row * k;
-                int newCol = (int) pos.col + col * k;
-                if (newRow < 0 || ((unsigned) newRow) >= board.size() || newCol < 0 ||
-                    ((unsigned) newCol) >= board[newRow].size())
-                    break; // Exit if we are outside the game board
-                if (board[newRow][newCol] == EMPTY)
-                    break; // Exit if the cell is empty
-                if (board[newRow][newCol] == player) {
-                    if (k > 1) {
-                        // If we found a piece of the current player after finding a piece of the
-                        // other player, then the move is valid
-                        return true;
-                    }
-                    break;
-                }
-                k++;
-            }
-        }
+    const RayTables::SquareRays &entry = RayTables::SQUARES[pos.row * BOARD_SIZE + pos.col];
+    for (int d = 0; d < RayTables::DIRECTION_COUNT; d++) {
+        if (!((entry.directionMask >> d) & 1))
+            continue; // Ray too short to hold a reversal
+        if (countRayFlips(board, entry.rays[d], player) > 0)
+            return true;
     }
     return false;
 }
 
 bool BoardHelper::isValidMove(const std::vector<std::vector<char>> &board, const Position &pos, char player) {
+    if (pos.row >= BOARD_SIZE || pos.col >= BOARD_SIZE)
+        return false; // Check if the cell is within the game board limits
     if (board[pos.row][pos.col] != EMPTY)
         return false; // Check if the cell is empty
-    if (pos.row < 0 || pos.row >= BOARD_SIZE || pos.col < 0 || pos.col >= BOARD_SIZE)
-        return false; // Check if the cell is within the game board limits
 
     return isReversible(board, pos, player);
 }
 
-void BoardHelper::reversePieces(std::vector<std::vector<char>> &board, const Position &pos,
-                                char player) {
-    // Check the eight directions around the cell
-    for (int i = -1; i <= 1; i++) {
-        for (int j = -1; j <= 1; j++) {
-            if (i == 0 && j == 0)
-                continue; // Ignore the current cell
-            int k = 1;
-            while (true) {
-                int newRow = (int) pos.row + i * k;
-                int newCol = (int) pos.col + j * k;
-                if (newRow < 0 || ((unsigned int) newRow) >= board.size() || newCol < 0 ||
-                    ((unsigned int) newCol) >= board[newRow].size())
-                    break; // Exit if we are outside the game board
-                if (board[newRow][newCol] == EMPTY)
-                    break; // Exit if the cell is empty
-                if (board[newRow][newCol] == player) {
-                    if (k > 1) {
-                        for (int k2 = k - 1; k2 > 0; k2--)
-                            board[pos.row + i * k2][pos.col + j * k2] = player;
-                        break;
-                    }
-                    break;
-                }
-                k++;
-            }
+bool BoardHelper::isValidMove(const std::vector<std::vector<char>> &board, Square square, char player) {
+    Position pos = toPosition(square);
+    if (board[pos.row][pos.col] != EMPTY)
+        return false;
+    return isReversible(board, pos, player);
+}
+
+/**
+ * Shared by both reversePieces and the recording playMove, so that they can never disagree on
+ * which pieces a move reverses.
+ */
+static void reversePiecesRecorded(std::vector<std::vector<char>> &board, unsigned int row,
+                                  unsigned int col, char player, MoveUndo *undo) {
+    PROFILE_SCOPE(FLIPS);
+    const RayTables::SquareRays &entry = RayTables::SQUARES[row * BOARD_SIZE + col];
+    for (int d = 0; d < RayTables::DIRECTION_COUNT; d++) {
+        if (!((entry.directionMask >> d) & 1))
+            continue; // Ray too short to hold a reversal
+        const RayTables::Ray &ray = entry.rays[d];
+        int flips = countRayFlips(board, ray, player);
+        for (int k = 0; k < flips; k++) {
+            board[ray.squares[k] / BOARD_SIZE][ray.squares[k] % BOARD_SIZE] = player;
+            if (undo)
+                undo->flipped[undo->flipCount++] = ray.squares[k];
         }
     }
 }
 
+void BoardHelper::reversePieces(std::vector<std::vector<char>> &board, const Position &pos,
+                                char player) {
+    reversePiecesRecorded(board, pos.row, pos.col, player, nullptr);
+}
+
 void BoardHelper::playMove(std::vector<std::vector<char>> &board, const Position &pos, char player) {
     // if (!isValidMove(board, pos, player)) throw invalid_argument("Invalid move");
     board[pos.row][pos.col] = player; // Place the current player's piece on the chosen cell
     reversePieces(board, pos, player);
 }
 
+void BoardHelper::playMove(std::vector<std::vector<char>> &board, Square square, char player, MoveUndo &undo) {
+    undo.square = square;
+    undo.flipCount = 0;
+    board[square / BOARD_SIZE][square % BOARD_SIZE] = player;
+    reversePiecesRecorded(board, square / BOARD_SIZE, square % BOARD_SIZE, player, &undo);
+}
+
+void BoardHelper::undoMove(std::vector<std::vector<char>> &board, const MoveUndo &undo) {
+    char player = board[undo.square / BOARD_SIZE][undo.square % BOARD_SIZE];
+    char oPlayer = (player == PLAYER_X) ? PLAYER_O : PLAYER_X;
+    for (int i = 0; i < undo.flipCount; i++)
+        board[undo.flipped[i] / BOARD_SIZE][undo.flipped[i] % BOARD_SIZE] = oPlayer;
+    board[undo.square / BOARD_SIZE][undo.square % BOARD_SIZE] = EMPTY;
+}
+
 std::vector<Position> BoardHelper::getAllPossibleMoves(const std::vector<std::vector<char>> &board, char player) {
     std::vector<Position> result;
     for (unsigned int row = 0; row < board.size(); ++row) {
@@ -131,21 +164,40 @@ std::vector<Position> BoardHelper::getAllPossibleMoves(const std::vector<std::ve
     return result;
 }
 
+void BoardHelper::getAllPossibleMoves(const std::vector<std::vector<char>> &board, char player, MoveList &moves) {
+    PROFILE_SCOPE(MOVE_GENERATION);
+    moves.clear();
+    for (unsigned int row = 0; row < BOARD_SIZE; ++row) {
+        for (unsigned int col = 0; col < BOARD_SIZE; col++) {
+            if (board[row][col] == EMPTY && hasOpponentNeighbor(board, row, col, player) &&
+                isReversible(board, Position(row, col), player))
+                moves.push(static_cast<Square>(row * BOARD_SIZE + col));
+        }
+    }
+}
+
+bool BoardHelper::hasAnyMove(const std::vector<std::vector<char>> &board, char player) {
+    for (unsigned int row = 0; row < BOARD_SIZE; ++row) {
+        for (unsigned int col = 0; col < BOARD_SIZE; col++) {
+            if (board[row][col] == EMPTY && hasOpponentNeighbor(board, row, col, player) &&
+                isReversible(board, Position(row, col), player))
+                return true;
+        }
+    }
+    return false;
+}
+
 bool BoardHelper::isGameFinished(const std::vector<std::vector<char>> &board) {
-    return (getAllPossibleMoves(board, 'X').empty() && getAllPossibleMoves(board, 'O').empty());
+    return !hasAnyMove(board, PLAYER_X) && !hasAnyMove(board, PLAYER_O);
 }
 
 bool BoardHelper::switchPlayer(const std::vector<std::vector<char>> &board, char &player) {
     char newPlayer = (player == PLAYER_X) ? PLAYER_O : PLAYER_X;
-    auto newPlayerMoves = getAllPossibleMoves(board, newPlayer);
-    auto currentPlayerMoves = getAllPossibleMoves(board, player);
-    if (!newPlayerMoves.empty()) {
+    if (hasAnyMove(board, newPlayer)) {
         player = newPlayer;
         return true;
     }
-    if (!currentPlayerMoves.empty())
-        return true;
-    return false;
+    return hasAnyMove(board, player);
 }
 
 int BoardHelper::countPiecesPlayer(const std::vector<std::vector<char>> &board, char player) {
@@ -0,0 +1,67 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/ConcurrentHashSet.hpp"
+
+ConcurrentHashSet::ConcurrentHashSet(std::size_t capacity) {
+    std::size_t slotCount = 1;
+    while (slotCount < capacity)
+        slotCount <<= 1;
+    slots = std::make_unique<std::atomic<std::uint64_t>[]>(slotCount);
+    for (std::size_t i = 0; i < slotCount; i++)
+        slots[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+    mask = slotCount - 1;
+}
+
+ConcurrentHashSet::InsertResult ConcurrentHashSet::insert(std::uint64_t key) {
+    if (key == EMPTY_SLOT) {
+        if (zeroInserted.exchange(true, std::memory_order_acq_rel))
+            return PRESENT;
+        count.fetch_add(1, std::memory_order_relaxed);
+        return INSERTED;
+    }
+    std::size_t index = static_cast<std::size_t>(key) & mask;
+    for (std::size_t probe = 0; probe < MAX_PROBES && probe <= mask; probe++) {
+        std::atomic<std::uint64_t> &slot = slots[(index + probe) & mask];
+        std::uint64_t current = slot.load(std::memory_order_acquire);
+        if (current == key)
+            return PRESENT;
+        if (current == EMPTY_SLOT) {
+            if (slot.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                count.fetch_add(1, std::memory_order_relaxed);
+                return INSERTED;
+            }
+            if (current == key) // another thread claimed the slot for the same key
+                return PRESENT;
+        }
+    }
+    return FULL;
+}
+
+bool ConcurrentHashSet::contains(std::uint64_t key) const {
+    if (key == EMPTY_SLOT)
+        return zeroInserted.load(std::memory_order_acquire);
+    std::size_t index = static_cast<std::size_t>(key) & mask;
+    for (std::size_t probe = 0; probe < MAX_PROBES && probe <= mask; probe++) {
+        std::uint64_t current = slots[(index + probe) & mask].load(std::memory_order_acquire);
+        if (current == key)
+            return true;
+        if (current == EMPTY_SLOT)
+            return false;
+    }
+    return false;
+}
\ No newline at end of file
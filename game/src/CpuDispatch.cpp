@@ -0,0 +1,115 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/CpuDispatch.hpp"
+#include <cstdlib>
+#include <cstring>
+
+namespace CpuDispatch {
+
+extern const Kernels BASELINE_KERNELS;
+#if defined(OTHELLO_X86_DISPATCH)
+extern const Kernels POPCNT_KERNELS;
+extern const Kernels BMI2_KERNELS;
+extern const Kernels AVX2_KERNELS;
+extern const Kernels AVX512_KERNELS;
+#endif
+
+static const char *const ISA_NAMES[ISA_COUNT] = {"baseline", "popcnt", "bmi2", "avx2", "avx512"};
+
+// constant initialized, so the kernels can be used by other static initializers before select runs
+const Kernels *active = &BASELINE_KERNELS;
+
+/** Highest level the CPU supports, ignoring OTHELLO_ISA. */
+static Isa detectCpu() {
+#if defined(OTHELLO_X86_DISPATCH)
+    __builtin_cpu_init();
+    if (!__builtin_cpu_supports("popcnt"))
+        return ISA_BASELINE;
+    if (!__builtin_cpu_supports("bmi2"))
+        return ISA_POPCNT;
+    if (!__builtin_cpu_supports("avx2"))
+        return ISA_BMI2;
+    if (!__builtin_cpu_supports("avx512f") || !__builtin_cpu_supports("avx512bw") ||
+        !__builtin_cpu_supports("avx512vl"))
+        return ISA_AVX2;
+    return ISA_AVX512;
+#else
+    return ISA_BASELINE;
+#endif
+}
+
+Isa detect() {
+    Isa isa = detectCpu();
+    const char *cap = std::getenv("OTHELLO_ISA");
+    if (cap) {
+        for (int level = 0; level < isa; level++) {
+            if (std::strcmp(cap, ISA_NAMES[level]) == 0)
+                return static_cast<Isa>(level);
+        }
+    }
+    return isa;
+}
+
+const Kernels *variant(Isa isa) {
+    switch (isa) {
+        case ISA_BASELINE: return &BASELINE_KERNELS;
+#if defined(OTHELLO_X86_DISPATCH)
+        case ISA_POPCNT: return &POPCNT_KERNELS;
+        case ISA_BMI2: return &BMI2_KERNELS;
+        case ISA_AVX2: return &AVX2_KERNELS;
+        case ISA_AVX512: return &AVX512_KERNELS;
+#endif
+        default: return nullptr;
+    }
+}
+
+const Kernels &select(Isa isa) {
+    Isa supported = detectCpu();
+    for (int level = isa < supported ? isa : supported; level >= ISA_BASELINE; level--) {
+        const Kernels *kernels = variant(static_cast<Isa>(level));
+        if (kernels) {
+            active = kernels;
+            break;
+        }
+    }
+    return *active;
+}
+
+void printReport(std::ostream &out) {
+    Isa supported = detectCpu();
+    out << "CPU support:";
+    for (int level = ISA_POPCNT; level < ISA_COUNT; level++)
+        out << " " << ISA_NAMES[level] << (level <= supported ? "=yes" : "=no");
+    out << std::endl;
+    out << "Built variants:";
+    for (int level = ISA_BASELINE; level < ISA_COUNT; level++) {
+        if (variant(static_cast<Isa>(level)))
+            out << " " << ISA_NAMES[level];
+    }
+    out << std::endl;
+    out << "Active kernels: " << active->name;
+    const char *cap = std::getenv("OTHELLO_ISA");
+    if (cap)
+        out << " (OTHELLO_ISA=" << cap << ")";
+    out << std::endl;
+}
+
+// picks the variant once, before main
+[[maybe_unused]] static const Kernels &initialSelection = select(detect());
+
+} // namespace CpuDispatch
\ No newline at end of file
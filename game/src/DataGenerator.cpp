@@ -0,0 +1,157 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/DataGenerator.hpp"
+#include "../include/ConcurrentHashSet.hpp"
+#include "../include/EndgameSolver.hpp"
+#include "../include/Solver.hpp"
+#include "../include/ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <numeric>
+#include <random>
+
+constexpr char PLAYER_X = 'X';
+
+void DataGenerator::encodeRecord(const Bitboard &position, int score, std::uint8_t flags, Square bestMove,
+                                 std::uint8_t *out) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = static_cast<std::uint8_t>(position.player >> (8 * i));
+        out[8 + i] = static_cast<std::uint8_t>(position.opponent >> (8 * i));
+    }
+    auto unsignedScore = static_cast<std::uint32_t>(score);
+    for (int i = 0; i < 4; i++)
+        out[16 + i] = static_cast<std::uint8_t>(unsignedScore >> (8 * i));
+    out[20] = static_cast<std::uint8_t>(position.countEmpties());
+    out[21] = flags;
+    out[22] = bestMove;
+    out[23] = 0;
+}
+
+/** Returns the n-th set square of a mask, n counted from the lowest square. */
+static Square nthSquare(std::uint64_t mask, int n) {
+    while (n-- > 0)
+        mask &= mask - 1;
+    return Bitboard::firstSquare(mask);
+}
+
+std::uint64_t DataGenerator::generate(const DataGenOptions &options, std::ostream &out, std::ostream &log) {
+    std::vector<std::vector<char>> initialBoard;
+    BoardHelper::initBoard(initialBoard);
+    const Bitboard initial = Bitboard::fromBoard(initialBoard, PLAYER_X);
+
+    std::size_t dedupCapacity = options.dedupCapacity;
+    if (dedupCapacity == 0) // twice the most positions the run can write, so the probes stay short
+        dedupCapacity = 2 * static_cast<std::size_t>(std::max(options.games, 1)) *
+                        static_cast<std::size_t>(std::max(options.samplesPerGame, 1));
+    ConcurrentHashSet seen(dedupCapacity);
+    std::mutex outMutex;
+    std::atomic<std::uint64_t> written{0}, duplicates{0}, unchecked{0}, exact{0}, gamesDone{0};
+    auto start = std::chrono::steady_clock::now();
+
+    ThreadPool pool(options.threads);
+    TaskGroup group;
+    for (int g = 0; g < options.games; g++) {
+        pool.submit(group, [&, g]() {
+            std::mt19937_64 random(options.seed + static_cast<std::uint64_t>(g));
+            TranspositionTable table(options.tableMegabytes);
+            SearchContext context;
+            Solver solver(context, &table);
+            EndgameSolver endgameSolver;
+            std::vector<std::vector<char>> board;
+
+            // self-play, keeping the positions after the random opening
+            std::vector<Bitboard> positions;
+            Bitboard position = initial;
+            for (int ply = 0;; ply++) {
+                std::uint64_t moves = position.getMoves();
+                if (moves == 0) {
+                    position.pass();
+                    if (position.getMoves() == 0)
+                        break;
+                    moves = position.getMoves();
+                }
+                Square move;
+                if (ply < options.randomPlies) {
+                    move = nthSquare(moves, static_cast<int>(random() % Bitboard::popCount(moves)));
+                } else {
+                    positions.push_back(position);
+                    position.toBoard(board, PLAYER_X);
+                    move = solver.searchSquare(board, PLAYER_X, options.playDepth);
+                }
+                position.play(move, position.getFlips(move));
+            }
+
+            // label a random sample of the positions not seen yet
+            std::vector<std::size_t> order(positions.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::shuffle(order.begin(), order.end(), random);
+            std::vector<std::uint8_t> records;
+            int sampled = 0;
+            for (std::size_t index: order) {
+                if (sampled >= options.samplesPerGame)
+                    break;
+                const Bitboard &sample = positions[index];
+                ConcurrentHashSet::InsertResult inserted = seen.insert(sample.canonical().hash());
+                if (inserted == ConcurrentHashSet::PRESENT) {
+                    duplicates.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                // a full set can no longer tell duplicates: the position is kept rather than lost
+                if (inserted == ConcurrentHashSet::FULL && unchecked.fetch_add(1, std::memory_order_relaxed) == 0) {
+                    std::lock_guard<std::mutex> lock(outMutex);
+                    log << "duplicate set full (" << seen.capacity()
+                        << " slots): positions are no longer checked, raise --dedup-capacity" << std::endl;
+                }
+                sampled++;
+                int score;
+                Square best;
+                std::uint8_t flags = 0;
+                if (sample.countEmpties() <= options.exactEmpties) {
+                    EndgameResult result = endgameSolver.solve(sample);
+                    score = result.score;
+                    best = result.bestMove;
+                    flags |= FLAG_EXACT;
+                    exact.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    sample.toBoard(board, PLAYER_X);
+                    MoveAnalysis analysis = solver.analyze(board, PLAYER_X, options.labelDepth, 1).front();
+                    score = analysis.score;
+                    best = toSquare(analysis.move);
+                }
+                records.resize(records.size() + RECORD_SIZE);
+                encodeRecord(sample, score, flags, best, &records[records.size() - RECORD_SIZE]);
+            }
+
+            std::lock_guard<std::mutex> lock(outMutex);
+            out.write(reinterpret_cast<const char *>(records.data()), static_cast<std::streamsize>(records.size()));
+            written.fetch_add(records.size() / RECORD_SIZE, std::memory_order_relaxed);
+            std::uint64_t done = gamesDone.fetch_add(1, std::memory_order_relaxed) + 1;
+            if (done % 1000 == 0)
+                log << "games " << done << "/" << options.games << ", records " << written.load() << std::endl;
+        });
+    }
+    pool.wait(group);
+    out.flush();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    log << "games=" << options.games << " records=" << written.load() << " exact=" << exact.load()
+        << " duplicates=" << duplicates.load() << " unchecked=" << unchecked.load() << " time=" << seconds << "s"
+        << " records/s=" << (seconds > 0 ? static_cast<double>(written.load()) / seconds : 0.0) << std::endl;
+    return written.load();
+}
\ No newline at end of file
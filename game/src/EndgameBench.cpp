@@ -0,0 +1,122 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/EndgameBench.hpp"
+#include "../include/EndgameSolver.hpp"
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <stdexcept>
+
+constexpr char EMPTY = '-';
+constexpr char PLAYER_X = 'X';
+constexpr char PLAYER_O = 'O';
+constexpr int BOARD_SIZE = 8;
+
+/** Built-in endgame positions, numbered as in the FFO set, with the exact score of the player to move */
+static const EndgameBench::Position BUILTIN_POSITIONS[] = {
+        {40, "O--OOOOX-OOOOOOXOOXXOOOXOOXOOOXXOOOOOOXX---OOOOX----O--X--------", PLAYER_X, 38},
+        {41, "-OOOOO----OOOOX--OOOOOO-XXXXXOO--XXOOX--OOXOXX----OXXO---OOO--O-", PLAYER_X, 0},
+        {45, "---XXXX-X-XXXO--XXOXOO--XXXOXO--XXOXXO---OXXXOO-O-OOOO------OO--", PLAYER_X, 6},
+};
+
+std::vector<EndgameBench::Position> EndgameBench::builtinPositions() {
+    return {std::begin(BUILTIN_POSITIONS), std::end(BUILTIN_POSITIONS)};
+}
+
+std::vector<EndgameBench::Position> EndgameBench::readPositions(std::istream &in, int firstNumber) {
+    std::vector<Position> positions;
+    std::string line;
+    for (int number = 1; std::getline(in, line); number++) {
+        if (line.empty())
+            continue;
+        std::size_t separator = line.find(';');
+        std::size_t colon = line.find(':', separator);
+        if (line.size() < BOARD_SIZE * BOARD_SIZE + 2 || separator == std::string::npos || colon == std::string::npos)
+            throw std::runtime_error("line " + std::to_string(number) + ": expected \"<squares> <player>; <move>:<score>\"");
+        Position position{firstNumber + static_cast<int>(positions.size()), line.substr(0, BOARD_SIZE * BOARD_SIZE),
+                          line[BOARD_SIZE * BOARD_SIZE + 1], 0};
+        for (char &square: position.squares) {
+            if (square == '.')
+                square = EMPTY;
+            if (square != EMPTY && square != PLAYER_X && square != PLAYER_O)
+                throw std::runtime_error("line " + std::to_string(number) + ": invalid square '" + square + "'");
+        }
+        if (position.player != PLAYER_X && position.player != PLAYER_O)
+            throw std::runtime_error("line " + std::to_string(number) + ": invalid player");
+        position.score = std::stoi(line.substr(colon + 1));
+        positions.push_back(position);
+    }
+    return positions;
+}
+
+EndgameBenchResult EndgameBench::run(const std::vector<Position> &positions, const EndgameBenchOptions &options,
+                                     std::ostream &out) {
+    std::unique_ptr<ThreadPool> pool;
+    if (options.threads != 1)
+        pool = std::make_unique<ThreadPool>(options.threads);
+    std::unique_ptr<EndgameTable> table;
+    if (options.tableMegabytes > 0)
+        table = std::make_unique<EndgameTable>(options.tableMegabytes);
+    out << "threads   : " << (pool ? pool->size() : 1) << std::endl;
+    out << "table     : " << (table ? std::to_string(options.tableMegabytes) + " MB" : "none") << std::endl;
+
+    EndgameBenchResult result;
+    for (const Position &position: positions) {
+        if ((options.first > 0 && position.number < options.first) || (options.last > 0 && position.number > options.last))
+            continue;
+        Bitboard board;
+        for (int square = 0; square < BOARD_SIZE * BOARD_SIZE; square++) {
+            if (position.squares[square] == position.player)
+                board.player |= 1ULL << square;
+            else if (position.squares[square] != EMPTY)
+                board.opponent |= 1ULL << square;
+        }
+
+        if (table)
+            table->clear();
+        EndgameSolver solver(pool.get(), EndgameSolver::DEFAULT_SPLIT_MIN_EMPTIES, table.get());
+        auto start = std::chrono::steady_clock::now();
+        EndgameResult solved = solver.solve(board);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        bool correct = solved.score == position.score;
+        result.positions++;
+        result.failures += correct ? 0 : 1;
+        result.nodes += solved.nodes;
+        result.seconds += seconds;
+        std::string move = solved.bestMove == NO_SQUARE ? std::string("pass")
+                                                        : std::string{static_cast<char>('a' + solved.bestMove % BOARD_SIZE),
+                                                                      static_cast<char>('1' + solved.bestMove / BOARD_SIZE)};
+        out << "#" << std::setw(2) << position.number << ": empties " << std::setw(2) << board.countEmpties()
+            << "  move " << move << "  score " << std::showpos << std::setw(3) << solved.score << std::noshowpos;
+        if (!correct)
+            out << " (expected " << std::showpos << position.score << std::noshowpos << ")";
+        out << "  nodes " << std::setw(12) << solved.nodes << "  " << std::fixed << std::setprecision(3) << seconds
+            << " s  " << std::defaultfloat << static_cast<unsigned long long>(solved.nodes / (seconds > 0 ? seconds : 1))
+            << " nps" << (correct ? "" : "  WRONG") << std::endl;
+    }
+
+    out << "==========================" << std::endl;
+    out << "positions : " << result.positions << std::endl;
+    out << "wrong     : " << result.failures << std::endl;
+    out << "nodes     : " << result.nodes << std::endl;
+    out << "time (s)  : " << std::fixed << std::setprecision(3) << result.seconds << std::defaultfloat << std::endl;
+    out << "nps       : " << static_cast<unsigned long long>(result.nodes / (result.seconds > 0 ? result.seconds : 1))
+        << std::endl;
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,179 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/EndgameSolver.hpp"
+#include <algorithm>
+
+constexpr std::uint64_t CORNERS = 0x8100000000000081ULL;
+constexpr int ORDERING_MIN_EMPTIES = 6; // below, ordering costs more than it saves
+constexpr int TABLE_MIN_EMPTIES = 9;     // below, a table lookup costs more than the subtree
+constexpr int HASH_MOVE_SCORE = 1000;    // above any fastest-first score
+constexpr int SCORE_INF = 65;           // above any final disc difference
+
+EndgameResult EndgameSolver::solve(const Bitboard &board, int alpha, int beta) {
+    nodes = 0;
+    unsigned long long rootNodes = 0;
+    EndgameResult result;
+    result.score = search(board, alpha, beta, false, nullptr, rootNodes, &result.bestMove);
+    result.nodes = nodes + rootNodes;
+    return result;
+}
+
+EndgameResult EndgameSolver::solve(const std::vector<std::vector<char>> &board, char player) {
+    return solve(Bitboard::fromBoard(board, player));
+}
+
+bool EndgameSolver::isAborted(const SplitPoint *splitPoint) {
+    for (; splitPoint; splitPoint = splitPoint->parent)
+        if (splitPoint->aborted.load(std::memory_order_relaxed))
+            return true;
+    return false;
+}
+
+int EndgameSolver::search(const Bitboard &board, int alpha, int beta, bool passed, const SplitPoint *splitPoint,
+                          unsigned long long &nodes, Square *bestMove) {
+    nodes++;
+    if (splitPoint && isAborted(splitPoint))
+        return 0; // discarded by the split point
+    std::uint64_t moveMask = board.getMoves();
+    if (!moveMask) {
+        if (passed) // neither player can play
+            return board.getFinalScore();
+        Bitboard next = board;
+        next.pass();
+        return -search(next, -beta, -alpha, true, splitPoint, nodes, nullptr);
+    }
+
+    int empties = board.countEmpties();
+    bool useTable = table && empties >= TABLE_MIN_EMPTIES;
+    std::uint64_t key = 0;
+    EndgameTable::Entry stored;
+    if (useTable) {
+        key = board.hash();
+        // the root needs its best move, so it only takes the move ordering from the table
+        if (table->probe(key, stored) && !bestMove) {
+            if (stored.lower >= beta)
+                return stored.lower;
+            if (stored.upper <= alpha)
+                return stored.upper;
+            if (stored.lower == stored.upper)
+                return stored.lower;
+            alpha = std::max(alpha, stored.lower);
+            beta = std::min(beta, stored.upper);
+        }
+    }
+    int windowAlpha = alpha;
+
+    // fastest-first ordering: moves leaving the opponent the fewest replies, corners first, after
+    // the best move of an earlier search of the position
+    MoveList moves;
+    for (std::uint64_t mask = moveMask; mask; mask &= mask - 1)
+        moves.push(Bitboard::firstSquare(mask));
+    if (empties >= ORDERING_MIN_EMPTIES) {
+        for (int i = 0; i < moves.size(); i++) {
+            Bitboard child = board;
+            child.play(moves[i], board.getFlips(moves[i]));
+            moves.score(i) = -Bitboard::popCount(child.getMoves()) + ((CORNERS >> moves[i]) & 1) * 4;
+            if (moves[i] == stored.bestMove)
+                moves.score(i) = HASH_MOVE_SCORE;
+        }
+        moves.sortByScore();
+    }
+
+    int bestScore = -SCORE_INF;
+    Square best = NO_SQUARE;
+    for (int i = 0; i < moves.size(); i++) {
+        Bitboard child = board;
+        child.play(moves[i], board.getFlips(moves[i]));
+        int score;
+        if (i == 0) {
+            score = -search(child, -beta, -alpha, false, splitPoint, nodes, nullptr);
+        } else {
+            // principal variation search: prove the younger move is not better with a null window
+            score = -search(child, -alpha - 1, -alpha, false, splitPoint, nodes, nullptr);
+            if (score > alpha && score < beta)
+                score = -search(child, -beta, -alpha, false, splitPoint, nodes, nullptr);
+        }
+        if (splitPoint && isAborted(splitPoint))
+            return 0;
+        if (score > bestScore) {
+            bestScore = score;
+            best = moves[i];
+        }
+        if (bestScore > alpha)
+            alpha = bestScore;
+        if (alpha >= beta)
+            break; // Cutoff
+        if (i == 0 && pool && empties >= splitMinEmpties && moves.size() > 1) {
+            // the eldest brother did not cut off: search the younger ones in parallel
+            bestScore = searchSplit(board, moves.begin() + 1, moves.size() - 1, alpha, beta, bestScore, best,
+                                    splitPoint);
+            break;
+        }
+    }
+    if (useTable && !(splitPoint && isAborted(splitPoint))) {
+        // the bounds stored earlier still hold, the search tightens one of them
+        if (bestScore > windowAlpha)
+            stored.lower = bestScore;
+        if (bestScore < beta)
+            stored.upper = bestScore;
+        stored.bestMove = best;
+        table->store(key, empties, stored);
+    }
+    if (bestMove)
+        *bestMove = best;
+    return bestScore;
+}
+
+int EndgameSolver::searchSplit(const Bitboard &board, const Square *moves, int moveCount, int alpha, int beta,
+                               int bestScore, Square &bestMove, const SplitPoint *parent) {
+    SplitPoint splitPoint(parent, alpha, beta, bestScore, bestMove);
+    TaskGroup group;
+    // queued in reverse: the pool runs its own newest tasks first, so the best ordered moves go
+    // first here, while idle workers steal the least promising ones
+    for (int i = moveCount - 1; i >= 0; i--) {
+        Square move = moves[i];
+        pool->submit(group, [this, &board, &splitPoint, move]() {
+            if (isAborted(&splitPoint))
+                return;
+            unsigned long long taskNodes = 0;
+            Bitboard child = board;
+            child.play(move, board.getFlips(move));
+            int childAlpha = splitPoint.alpha.load(std::memory_order_relaxed);
+            int score = -search(child, -childAlpha - 1, -childAlpha, false, &splitPoint, taskNodes, nullptr);
+            if (score > childAlpha && score < splitPoint.beta) {
+                childAlpha = splitPoint.alpha.load(std::memory_order_relaxed);
+                score = -search(child, -splitPoint.beta, -childAlpha, false, &splitPoint, taskNodes, nullptr);
+            }
+            nodes.fetch_add(taskNodes, std::memory_order_relaxed);
+            if (isAborted(&splitPoint))
+                return;
+            std::lock_guard<std::mutex> lock(splitPoint.bestMutex);
+            if (score > splitPoint.bestScore) {
+                splitPoint.bestScore = score;
+                splitPoint.bestMove = move;
+            }
+            if (score > splitPoint.alpha.load(std::memory_order_relaxed))
+                splitPoint.alpha.store(score, std::memory_order_relaxed);
+            if (score >= splitPoint.beta)
+                splitPoint.aborted.store(true, std::memory_order_relaxed); // Cutoff: stop the brothers
+        });
+    }
+    pool->wait(group);
+    bestMove = splitPoint.bestMove;
+    return splitPoint.bestScore;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/EndgameTable.hpp"
+
+EndgameTable::EndgameTable(std::size_t sizeInMegabytes) {
+    std::size_t count = 2;
+    while (count * 2 * sizeof(std::uint64_t) <= sizeInMegabytes * 1024 * 1024)
+        count *= 2;
+    slots = std::make_unique<std::atomic<std::uint64_t>[]>(count);
+    mask = count - 2;
+    clear();
+}
+
+std::uint64_t EndgameTable::pack(std::uint64_t key, int empties, const Entry &entry) {
+    return (key & ~DATA_MASK) | static_cast<std::uint64_t>(entry.lower + 65) |
+           static_cast<std::uint64_t>(entry.upper + 64) << 8 | static_cast<std::uint64_t>(entry.bestMove) << 16 |
+           static_cast<std::uint64_t>(empties) << 23;
+}
+
+bool EndgameTable::probe(std::uint64_t key, Entry &entry) const {
+    std::size_t index = key & mask;
+    for (std::size_t i = index; i < index + 2; i++) {
+        std::uint64_t slot = slots[i].load(std::memory_order_relaxed);
+        if (slot == 0 || (slot & ~DATA_MASK) != (key & ~DATA_MASK))
+            continue;
+        entry.lower = static_cast<int>(slot & 0xFF) - 65;
+        entry.upper = static_cast<int>((slot >> 8) & 0xFF) - 64;
+        entry.bestMove = static_cast<Square>((slot >> 16) & 0x7F);
+        return true;
+    }
+    return false;
+}
+
+void EndgameTable::store(std::uint64_t key, int empties, const Entry &entry) {
+    std::size_t index = key & mask;
+    std::uint64_t slot = pack(key, empties, entry);
+    std::uint64_t first = slots[index].load(std::memory_order_relaxed);
+    bool samePosition = (first & ~DATA_MASK) == (key & ~DATA_MASK);
+    if (first == 0 || samePosition || empties >= static_cast<int>((first >> 23) & 0x3F))
+        slots[index].store(slot, std::memory_order_relaxed);
+    else
+        slots[index + 1].store(slot, std::memory_order_relaxed);
+}
+
+void EndgameTable::clear() {
+    for (std::size_t i = 0; i < mask + 2; i++)
+        slots[i].store(0, std::memory_order_relaxed);
+}
\ No newline at end of file
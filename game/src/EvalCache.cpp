@@ -0,0 +1,47 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/EvalCache.hpp"
+
+EvalCache::EvalCache(std::size_t sizeInMegabytes) {
+    std::size_t count = 1;
+    while (count * 2 * sizeof(std::uint64_t) <= sizeInMegabytes * 1024 * 1024)
+        count *= 2;
+    slots = std::make_unique<std::atomic<std::uint64_t>[]>(count);
+    mask = count - 1;
+    clear();
+}
+
+bool EvalCache::probe(std::uint64_t key, int &score) {
+    std::uint64_t slot = slots[key & mask].load(std::memory_order_relaxed);
+    if (slot == 0 || (slot & ~SCORE_MASK) != (key & ~SCORE_MASK))
+        return false;
+    score = static_cast<int>(slot & SCORE_MASK) - SCORE_BIAS;
+    return true;
+}
+
+void EvalCache::store(std::uint64_t key, int score) {
+    if (score < -MAX_SCORE || score > MAX_SCORE)
+        return;
+    std::uint64_t slot = (key & ~SCORE_MASK) | static_cast<std::uint64_t>(score + SCORE_BIAS);
+    slots[key & mask].store(slot, std::memory_order_relaxed);
+}
+
+void EvalCache::clear() {
+    for (std::size_t i = 0; i <= mask; i++)
+        slots[i].store(0, std::memory_order_relaxed);
+}
\ No newline at end of file
@@ -16,6 +16,9 @@
  */
 
 #include "../include/Evaluator.hpp"
+#include "../include/Profiler.hpp"
+#include "../include/ThreadPool.hpp"
+#include <algorithm>
 
 constexpr char EMPTY = '-';
 constexpr char PLAYER_X = 'X';
@@ -24,43 +27,80 @@ constexpr int BOARD_SIZE = 8;
 constexpr int MAX_PIECES = 64;
 const std::vector<std::pair<int, int>> CORNERS = {std::make_pair(0, 0), std::make_pair(0, 7),
                                                   std::make_pair(7, 0), std::make_pair(7, 7)};
+constexpr std::size_t BATCH_BLOCK = 256;   // boards copied to the kernel arrays at a time
+constexpr std::size_t BATCH_CHUNK = 16384; // boards per task of the pool
 
 Evaluator::GamePhase Evaluator::getGamePhase(const std::vector<std::vector<char>> &board) {
     int totalPiecesCount = BoardHelper::countPiecesTotal(board);
-    if (totalPiecesCount < 20)
+    if (totalPiecesCount < MID_GAME_DISCS)
         return EARLY_GAME;
-    else if (totalPiecesCount <= 58)
+    else if (totalPiecesCount < LATE_GAME_DISCS)
         return MID_GAME;
     else
         return LATE_GAME;
 }
 
 int Evaluator::getEvaluation(const std::vector<std::vector<char>> &board, char player) {
+    PROFILE_SCOPE(EVALUATION);
     // terminal
     if (BoardHelper::isGameFinished(board)) {
-        return 1000 * evalDiscDiff(board, player);
+        return FINAL_DISC_DIFF_WEIGHT * evalDiscDiff(board, player);
     }
     // semi-terminal
     if (getGamePhase(board) == EARLY_GAME) {
-        return 1000 * evalCorner(board, player) + 50 * evalMobility(board, player) +
-               30 * evalPositionalScore(board, player) + 30 * evalEdgeControl(board, player);
+        const Weights &w = EARLY_GAME_WEIGHTS;
+        return w.corner * evalCorner(board, player) + w.mobility * evalMobility(board, player) +
+               w.positional * evalPositionalScore(board, player) + w.edgeControl * evalEdgeControl(board, player);
     } else if (getGamePhase(board) == MID_GAME) {
-        return 1000 * evalCorner(board, player) + 20 * evalMobility(board, player) +
-               10 * evalDiscDiff(board, player) + 100 * evalParity(board) +
-               50 * evalPositionalScore(board, player) + 50 * evalEdgeControl(board, player);
+        const Weights &w = MID_GAME_WEIGHTS;
+        return w.corner * evalCorner(board, player) + w.mobility * evalMobility(board, player) +
+               w.discDiff * evalDiscDiff(board, player) + w.parity * evalParity(board) +
+               w.positional * evalPositionalScore(board, player) + w.edgeControl * evalEdgeControl(board, player);
     } else { // LATE_GAME
-        return 1000 * evalCorner(board, player) + 100 * evalMobility(board, player) +
-               500 * evalDiscDiff(board, player) + 500 * evalParity(board) +
-               100 * evalPositionalScore(board, player) + 100 * evalEdgeControl(board, player);
+        const Weights &w = LATE_GAME_WEIGHTS;
+        return w.corner * evalCorner(board, player) + w.mobility * evalMobility(board, player) +
+               w.discDiff * evalDiscDiff(board, player) + w.parity * evalParity(board) +
+               w.positional * evalPositionalScore(board, player) + w.edgeControl * evalEdgeControl(board, player);
     }
 }
 
+/**
+ * Copies a chunk of boards, a block at a time, to separate arrays of player and opponent discs,
+ * the layout the kernel loads into its vector lanes.
+ */
+static void evaluateChunk(const Bitboard *boards, std::size_t count, int *scores) {
+    std::uint64_t players[BATCH_BLOCK];
+    std::uint64_t opponents[BATCH_BLOCK];
+    for (std::size_t start = 0; start < count; start += BATCH_BLOCK) {
+        std::size_t size = std::min(BATCH_BLOCK, count - start);
+        for (std::size_t i = 0; i < size; i++) {
+            players[i] = boards[start + i].player;
+            opponents[i] = boards[start + i].opponent;
+        }
+        CpuDispatch::kernels().evaluateBatch(players, opponents, scores + start, static_cast<int>(size));
+    }
+}
+
+void Evaluator::getEvaluations(const Bitboard *boards, std::size_t count, int *scores, ThreadPool *pool) {
+    if (!pool || count <= BATCH_CHUNK) {
+        evaluateChunk(boards, count, scores);
+        return;
+    }
+    TaskGroup group;
+    for (std::size_t start = 0; start < count; start += BATCH_CHUNK) {
+        std::size_t size = std::min(BATCH_CHUNK, count - start);
+        pool->submit(group, [=]() { evaluateChunk(boards + start, size, scores + start); });
+    }
+    pool->wait(group);
+}
+
 /**
  * Disc difference (Measures the difference in the number of discs on the board. Has zero weight in
  * the opening, but increases to a moderate weight in the MID_GAME, and to a significant weight in
  * the endgame.)
  */
 int Evaluator::evalDiscDiff(const std::vector<std::vector<char>> &board, char player) {
+    PROFILE_SCOPE(EVAL_DISC_DIFF);
     char opponentPlayer = (player == PLAYER_X) ? PLAYER_O : PLAYER_X;
 
     int playerPiecesCount = BoardHelper::countPiecesPlayer(board, player);
@@ -75,11 +115,14 @@ int Evaluator::evalDiscDiff(const std::vector<std::vector<char>> &board, char pl
  * weight in the opening game, but diminishes to zero weight towards the endgame.)
  */
 int Evaluator::evalMobility(const std::vector<std::vector<char>> &board, char player) {
+    PROFILE_SCOPE(EVAL_MOBILITY);
     char opponentPlayer = (player == PLAYER_X) ? PLAYER_O : PLAYER_X;
 
-    int playerMoveCount = static_cast<int>(BoardHelper::getAllPossibleMoves(board, player).size());
-    int opponentMoveCount =
-            static_cast<int>(BoardHelper::getAllPossibleMoves(board, opponentPlayer).size());
+    MoveList moves;
+    BoardHelper::getAllPossibleMoves(board, player, moves);
+    int playerMoveCount = moves.size();
+    BoardHelper::getAllPossibleMoves(board, opponentPlayer, moves);
+    int opponentMoveCount = moves.size();
 
     return 100 * (playerMoveCount - opponentMoveCount) / (playerMoveCount + opponentMoveCount + 1);
 }
@@ -89,6 +132,7 @@ int Evaluator::evalMobility(const std::vector<std::vector<char>> &board, char pl
  * at all times.)
  */
 int Evaluator::evalCorner(const std::vector<std::vector<char>> &board, char player) {
+    PROFILE_SCOPE(EVAL_CORNER);
     char opponentPlayer = (player == PLAYER_X) ? PLAYER_O : PLAYER_X;
 
     int playerCorners = 0;
@@ -109,26 +153,18 @@ int Evaluator::evalCorner(const std::vector<std::vector<char>> &board, char play
  * opening, but increases to a very large weight in the MID_GAME and endgame.)
  */
 int Evaluator::evalParity(const std::vector<std::vector<char>> &board) {
+    PROFILE_SCOPE(EVAL_PARITY);
     int remainingDiscs = MAX_PIECES - BoardHelper::countPiecesTotal(board);
     return remainingDiscs % 2 == 0 ? -1 : 1;
 }
 
-const int scoreTable[8][8] = {
-        {120, -20, 20, 5,  5,  20, -20, 120},
-        {-20, -40, -5, -5, -5, -5, -40, -20},
-        {20,  -5,  15, 3,  3,  15, -5,  20},
-        {5,   -5,  3,  3,  3,  3,  -5,  5},
-        {5,   -5,  3,  3,  3,  3,  -5,  5},
-        {20,  -5,  15, 3,  3,  15, -5,  20},
-        {-20, -40, -5, -5, -5, -5, -40, -20},
-        {120, -20, 20, 5,  5,  20, -20, 120}};
-
 /**
  * This heuristic checks how well the player has managed to place their discs on the board. The
  * heuristic uses a predefined positional weight matrix, which assigns higher scores to stable
  * positions (corners and edges) and lower scores to unstable positions (adjacent to corners).
  */
 int Evaluator::evalPositionalScore(const std::vector<std::vector<char>> &board, char player) {
+    PROFILE_SCOPE(EVAL_POSITIONAL);
     char oPlayer = (player == PLAYER_X) ? PLAYER_O : PLAYER_X;
 
     int myEdges = 0;
@@ -165,13 +201,14 @@ int Evaluator::evalPositionalScore(const std::vector<std::vector<char>> &board,
  * (i.e., less likely to be flipped).
  */
 int Evaluator::evalEdgeControl(const std::vector<std::vector<char>> &board, char player) {
+    PROFILE_SCOPE(EVAL_EDGE_CONTROL);
     int score = 0;
     for (int i = 0; i < BOARD_SIZE; i++) {
         for (int j = 0; j < BOARD_SIZE; j++) {
             if (board[i][j] == player) {
-                score += scoreTable[i][j];
+                score += SQUARE_WEIGHTS[i][j];
             } else if (board[i][j] != EMPTY) {
-                score -= scoreTable[i][j];
+                score -= SQUARE_WEIGHTS[i][j];
             }
         }
     }
@@ -0,0 +1,277 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/GameRecord.hpp"
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+constexpr char PLAYER_X = 'X';
+constexpr char PLAYER_O = 'O';
+constexpr std::size_t HEADER_SIZE = 8;
+
+namespace GameRecord {
+
+static void encodeHeader(const Header &header, std::uint8_t *out) {
+    out[0] = header.moveCount;
+    out[1] = static_cast<std::uint8_t>(header.result);
+    out[2] = static_cast<std::uint8_t>(header.flags & 0xFF);
+    out[3] = static_cast<std::uint8_t>(header.flags >> 8);
+    for (int i = 0; i < 4; i++)
+        out[4 + i] = static_cast<std::uint8_t>(header.metadata >> (8 * i));
+}
+
+static Header decodeHeader(const std::uint8_t *in) {
+    Header header;
+    header.moveCount = in[0];
+    header.result = static_cast<std::int8_t>(in[1]);
+    header.flags = static_cast<std::uint16_t>(in[2] | (in[3] << 8));
+    header.metadata = 0;
+    for (int i = 0; i < 4; i++)
+        header.metadata |= static_cast<std::uint32_t>(in[4 + i]) << (8 * i);
+    return header;
+}
+
+static void encodeOffset(std::uint64_t offset, std::uint8_t *out) {
+    for (int i = 0; i < 8; i++)
+        out[i] = static_cast<std::uint8_t>(offset >> (8 * i));
+}
+
+static std::uint64_t decodeOffset(const std::uint8_t *in) {
+    std::uint64_t offset = 0;
+    for (int i = 0; i < 8; i++)
+        offset |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+    return offset;
+}
+
+/**
+ * Checks the next move of a game, after passing if the player to move cannot play.
+ */
+static void checkNext(std::vector<std::vector<char>> &board, char &player, Square move) {
+    if (!BoardHelper::hasAnyMove(board, player))
+        player = (player == PLAYER_X) ? PLAYER_O : PLAYER_X; // pass
+    if (move >= NO_SQUARE || !BoardHelper::isValidMove(board, move, player)) {
+        std::ostringstream message;
+        message << "illegal move " << toPosition(move) << " for " << player;
+        throw std::invalid_argument(message.str());
+    }
+}
+
+int finalResult(const std::vector<Square> &moves) {
+    std::vector<std::vector<char>> board;
+    BoardHelper::initBoard(board);
+    char player = PLAYER_X;
+    MoveUndo undo;
+    for (Square move: moves) {
+        checkNext(board, player, move);
+        BoardHelper::playMove(board, move, player, undo);
+        player = (player == PLAYER_X) ? PLAYER_O : PLAYER_X;
+    }
+    return BoardHelper::countPiecesPlayer(board, PLAYER_X) - BoardHelper::countPiecesPlayer(board, PLAYER_O);
+}
+
+void replay(const GameView &game,
+            const std::function<void(const std::vector<std::vector<char>> &, char, Square)> &visit) {
+    std::vector<std::vector<char>> board;
+    BoardHelper::initBoard(board);
+    char player = PLAYER_X;
+    MoveUndo undo;
+    for (int i = 0; i < game.header.moveCount; i++) {
+        Square move = game.moves[i];
+        checkNext(board, player, move);
+        visit(board, player, move);
+        BoardHelper::playMove(board, move, player, undo);
+        player = (player == PLAYER_X) ? PLAYER_O : PLAYER_X;
+    }
+}
+
+bool isRecordFile(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+Writer::Writer(const std::string &path) {
+    std::ifstream existing(path, std::ios::binary | std::ios::ate);
+    bool empty = !existing || existing.tellg() <= 0;
+    if (!empty && !isRecordFile(path))
+        throw std::runtime_error(path + " is not a game record file");
+    if (!empty)
+        offset = dropCutGame(path, existing);
+    existing.close();
+
+    data.open(path, std::ios::binary | std::ios::app);
+    index.open(path + ".idx", std::ios::binary | std::ios::app);
+    if (!data || !index)
+        throw std::runtime_error("cannot open " + path + " for writing");
+    if (empty) {
+        data.write(MAGIC, sizeof(MAGIC));
+        offset = sizeof(MAGIC);
+    }
+}
+
+void Writer::append(const std::vector<Square> &moves, int result, std::uint16_t flags, std::uint32_t metadata) {
+    if (moves.size() > 255)
+        throw std::invalid_argument("a game has at most 255 moves");
+    Header header;
+    header.moveCount = static_cast<std::uint8_t>(moves.size());
+    header.result = static_cast<std::int8_t>(result);
+    header.flags = flags;
+    header.metadata = metadata;
+    std::uint8_t bytes[HEADER_SIZE];
+    encodeHeader(header, bytes);
+    data.write(reinterpret_cast<const char *>(bytes), HEADER_SIZE);
+    data.write(reinterpret_cast<const char *>(moves.data()), static_cast<std::streamsize>(moves.size()));
+
+    std::uint8_t offsetBytes[8];
+    encodeOffset(offset, offsetBytes);
+    index.write(reinterpret_cast<const char *>(offsetBytes), sizeof(offsetBytes));
+    offset += HEADER_SIZE + moves.size();
+}
+
+std::uint64_t Writer::dropCutGame(const std::string &path, std::ifstream &existing) {
+    const auto length = static_cast<std::uint64_t>(existing.tellg());
+    std::vector<std::uint64_t> offsets;
+    std::uint64_t end = sizeof(MAGIC);
+    std::uint8_t header[HEADER_SIZE];
+    existing.seekg(static_cast<std::streamoff>(end));
+    while (end + HEADER_SIZE <= length && existing.read(reinterpret_cast<char *>(header), HEADER_SIZE) &&
+           end + HEADER_SIZE + header[0] <= length) {
+        offsets.push_back(end);
+        end += HEADER_SIZE + header[0];
+        existing.seekg(static_cast<std::streamoff>(end));
+    }
+    std::error_code error;
+    if (end < length)
+        std::filesystem::resize_file(path, end, error); // a game cut by a crash while writing
+    if (error)
+        throw std::runtime_error("cannot truncate " + path + ": " + error.message());
+
+    // the index must list exactly the games kept, or the next offset appended to it is out of step
+    std::ifstream indexIn(path + ".idx", std::ios::binary);
+    std::vector<std::uint64_t> indexed;
+    std::uint8_t bytes[8];
+    while (indexIn.read(reinterpret_cast<char *>(bytes), sizeof(bytes)))
+        indexed.push_back(decodeOffset(bytes));
+    bool partialEntry = indexIn.gcount() != 0;
+    indexIn.close();
+    if (indexed != offsets || partialEntry) {
+        std::ofstream indexOut(path + ".idx", std::ios::binary | std::ios::trunc);
+        for (std::uint64_t gameOffset: offsets) {
+            encodeOffset(gameOffset, bytes);
+            indexOut.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+        }
+        if (!indexOut)
+            throw std::runtime_error("cannot rewrite " + path + ".idx");
+    }
+    return end;
+}
+
+void Writer::flush() {
+    data.flush();
+    index.flush();
+}
+
+Reader::Reader(const std::string &path) {
+#if !defined(_WIN32)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat status{};
+    if (fd < 0 || ::fstat(fd, &status) < 0) {
+        if (fd >= 0)
+            ::close(fd);
+        throw std::runtime_error("cannot open " + path);
+    }
+    length = static_cast<std::size_t>(status.st_size);
+    if (length > 0) {
+        void *mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+            throw std::runtime_error("cannot map " + path);
+        ::madvise(mapping, length, MADV_SEQUENTIAL);
+        data = static_cast<const std::uint8_t *>(mapping);
+    } else {
+        ::close(fd);
+    }
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("cannot open " + path);
+    buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    length = buffer.size();
+#endif
+    if (length < sizeof(MAGIC) || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+#if !defined(_WIN32)
+        if (data)
+            ::munmap(const_cast<std::uint8_t *>(data), length);
+#endif
+        throw std::runtime_error(path + " is not a game record file");
+    }
+
+    // use the index if it matches the file, otherwise walk the headers
+    std::ifstream index(path + ".idx", std::ios::binary);
+    std::uint8_t bytes[8];
+    std::uint64_t expected = sizeof(MAGIC);
+    bool valid = true;
+    while (index.read(reinterpret_cast<char *>(bytes), sizeof(bytes))) {
+        std::uint64_t offset = decodeOffset(bytes);
+        if (offset != expected || offset + HEADER_SIZE > length) {
+            valid = false;
+            break;
+        }
+        offsets.push_back(offset);
+        expected = offset + HEADER_SIZE + data[offset];
+    }
+    if (!valid || expected != length) {
+        offsets.clear();
+        for (std::uint64_t offset = sizeof(MAGIC); offset + HEADER_SIZE <= length;
+             offset += HEADER_SIZE + data[offset])
+            offsets.push_back(offset);
+    }
+    if (!offsets.empty() && offsets.back() + HEADER_SIZE + data[offsets.back()] > length)
+        offsets.pop_back(); // game cut by a crash while writing
+}
+
+Reader::~Reader() {
+#if !defined(_WIN32)
+    if (data && buffer.empty())
+        ::munmap(const_cast<std::uint8_t *>(data), length);
+#endif
+    data = nullptr;
+}
+
+GameView Reader::game(std::size_t i) const {
+    GameView view;
+    view.header = decodeHeader(data + offsets[i]);
+    view.moves = data + offsets[i] + HEADER_SIZE;
+    return view;
+}
+
+void Reader::forEach(const std::function<void(const GameView &)> &visit) const {
+    for (std::size_t i = 0; i < offsets.size(); i++)
+        visit(game(i));
+}
+
+} // namespace GameRecord
\ No newline at end of file
@@ -0,0 +1,146 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/GameReview.hpp"
+#include "../include/EndgameSolver.hpp"
+#include "../include/Solver.hpp"
+#include "../include/ThreadPool.hpp"
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+constexpr char PLAYER_X = 'X';
+constexpr char PLAYER_O = 'O';
+
+std::vector<std::vector<Position>> GameReview::readGames(std::istream &in) {
+    std::vector<std::vector<Position>> games;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream moves(line);
+        std::vector<Position> game;
+        Position move;
+        while (moves >> std::ws && !moves.eof()) {
+            moves >> move;
+            game.push_back(move);
+        }
+        if (!game.empty())
+            games.push_back(game);
+    }
+    return games;
+}
+
+std::vector<PlyReview> GameReview::reviewGame(const std::vector<Position> &moves, const ReviewOptions &options,
+                                              TranspositionTable &table, EndgameTable &endgameTable) {
+    // replay the game forward to get the position before each move
+    std::vector<std::vector<std::vector<char>>> boards;
+    std::vector<char> players;
+    std::vector<std::vector<char>> board;
+    BoardHelper::initBoard(board);
+    char player = PLAYER_X;
+    for (const Position &move: moves) {
+        if (!BoardHelper::hasAnyMove(board, player))
+            player = (player == PLAYER_X) ? PLAYER_O : PLAYER_X; // pass
+        if (!BoardHelper::isValidMove(board, move, player)) {
+            std::ostringstream message;
+            message << "illegal move " << move << " at ply " << boards.size() + 1;
+            throw std::invalid_argument(message.str());
+        }
+        boards.push_back(board);
+        players.push_back(player);
+        BoardHelper::playMove(board, move, player);
+        player = (player == PLAYER_X) ? PLAYER_O : PLAYER_X;
+    }
+
+    // analyze from the end of the game, so that earlier plies reuse the table of later ones
+    std::vector<PlyReview> reviews(moves.size());
+    SearchContext context;
+    Solver solver(context, &table, nullptr, nullptr, options.store);
+    std::unique_ptr<SearchTrace::Writer> traceWriter;
+    if (options.trace) {
+        traceWriter = std::make_unique<SearchTrace::Writer>(*options.trace);
+        solver.setTrace(traceWriter.get());
+    }
+    EndgameSolver endgameSolver(nullptr, EndgameSolver::DEFAULT_SPLIT_MIN_EMPTIES, &endgameTable);
+    for (std::size_t ply = moves.size(); ply-- > 0;) {
+        PlyReview &review = reviews[ply];
+        review.player = players[ply];
+        review.played = moves[ply];
+        Bitboard position = Bitboard::fromBoard(boards[ply], players[ply]);
+        if (position.countEmpties() <= options.exactEmpties) {
+            EndgameResult best = endgameSolver.solve(position);
+            Bitboard child = position;
+            child.play(toSquare(moves[ply]), position.getFlips(toSquare(moves[ply])));
+            review.best = toPosition(best.bestMove);
+            review.bestScore = best.score;
+            review.playedScore = -endgameSolver.solve(child).score;
+            review.exact = true;
+        } else {
+            std::vector<MoveAnalysis> ranking = solver.analyze(boards[ply], players[ply], options.depth);
+            review.best = ranking.front().move;
+            review.bestScore = ranking.front().score;
+            review.playedScore = review.bestScore;
+            for (const MoveAnalysis &analysis: ranking)
+                if (analysis.move == moves[ply])
+                    review.playedScore = analysis.score;
+            review.exact = false;
+        }
+    }
+    return reviews;
+}
+
+int GameReview::reviewGames(const std::vector<std::vector<Position>> &games, const ReviewOptions &options,
+                            std::ostream &out) {
+    std::vector<std::string> reports(games.size());
+    std::vector<char> failed(games.size(), 0); // not vector<bool>: written from several threads
+    ThreadPool pool(options.threads);
+    TaskGroup group;
+    for (std::size_t g = 0; g < games.size(); g++) {
+        pool.submit(group, [&, g]() {
+            std::ostringstream report;
+            report << "game " << g + 1 << "\n";
+            try {
+                TranspositionTable table(options.tableMegabytes);
+                EndgameTable endgameTable(options.tableMegabytes);
+                std::vector<PlyReview> reviews = reviewGame(games[g], options, table, endgameTable);
+                int totalLoss[2] = {0, 0};
+                for (std::size_t ply = 0; ply < reviews.size(); ply++) {
+                    const PlyReview &review = reviews[ply];
+                    int loss = review.bestScore - review.playedScore;
+                    if (review.exact)
+                        totalLoss[review.player == PLAYER_X ? 0 : 1] += loss;
+                    report << "  " << ply + 1 << ". " << review.player << " " << review.played
+                           << " score=" << review.playedScore << " best=" << review.best
+                           << " best_score=" << review.bestScore << " loss=" << loss
+                           << (review.exact ? " (exact)" : "") << "\n";
+                }
+                report << "  exact disc loss: X=" << totalLoss[0] << " O=" << totalLoss[1] << "\n";
+            } catch (const std::exception &e) {
+                report << "  error: " << e.what() << "\n";
+                failed[g] = 1;
+            }
+            reports[g] = report.str();
+        });
+    }
+    pool.wait(group);
+
+    int failures = 0;
+    for (std::size_t g = 0; g < games.size(); g++) {
+        out << reports[g];
+        failures += failed[g];
+    }
+    return failures;
+}
\ No newline at end of file
@@ -0,0 +1,549 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/GameServer.hpp"
+#include "../include/Solver.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <random>
+#include <sstream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+constexpr char PLAYER_X = 'X';
+constexpr char PLAYER_O = 'O';
+constexpr int POLL_INTERVAL_MS = 5; // also the resolution of the clocks
+constexpr std::size_t MAX_OUTPUT_BYTES = 1 << 20; // a client that reads nothing more is dropped
+constexpr std::size_t MAX_INPUT_BYTES = 1 << 12; // and so is one whose line never ends
+
+/**
+ * @brief State of one game. Everything is guarded by mutex, and a search reads the board from
+ * its job, so the session lock is never held during a search.
+ */
+struct GameServer::Session {
+    int fd;
+    std::mutex mutex;
+    bool closed = false;
+    std::string input;
+    std::string output; // lines the socket has not taken yet
+
+    bool started = false;
+    std::vector<std::vector<char>> board;
+    char human = PLAYER_X;
+    char ai = PLAYER_O;
+    char toMove = PLAYER_X;
+    int depth = 6;
+    long long aiTimeLeftMs = -1; // no clock
+
+    bool searching = false;
+    std::chrono::steady_clock::time_point searchStart;
+    std::chrono::steady_clock::time_point deadline;
+    StopSource stopSource;
+    std::unique_ptr<TranspositionTable> table;
+
+    explicit Session(int fd) : fd(fd) {};
+
+    /** @brief Queues a line for the client and sends what the socket takes. The caller holds the lock. */
+    void send(const std::string &line) {
+        if (closed)
+            return;
+        output += line;
+        output += '\n';
+        flush();
+    }
+
+    /**
+     * @brief Sends as much of the queued output as the socket takes without blocking; the I/O
+     * thread sends the rest once the socket is writable. The caller holds the lock.
+     */
+    void flush() {
+#if !defined(_WIN32)
+        std::size_t sent = 0;
+        while (sent < output.size()) {
+            ssize_t n = ::send(fd, output.data() + sent, output.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0)
+                break; // the socket is full, or the client is gone and the I/O thread will notice
+            sent += static_cast<std::size_t>(n);
+        }
+        output.erase(0, sent);
+#endif
+    }
+};
+
+static int scoreX(const std::vector<std::vector<char>> &board) {
+    return BoardHelper::countPiecesPlayer(board, PLAYER_X) - BoardHelper::countPiecesPlayer(board, PLAYER_O);
+}
+
+GameServer::GameServer(ServerOptions options) : options(std::move(options)) {
+    unsigned int count = this->options.workers;
+    if (count == 0)
+        count = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0; i < count; i++)
+        workers.emplace_back(&GameServer::workerLoop, this);
+}
+
+GameServer::~GameServer() {
+    stopping = true;
+    for (auto &[fd, session]: sessions) {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        session->stopSource.requestStop();
+    }
+    queueCondition.notify_all();
+    for (std::thread &worker: workers)
+        worker.join();
+    for (auto &[fd, session]: sessions) {
+#if !defined(_WIN32)
+        ::close(fd);
+#endif
+    }
+}
+
+double GameServer::percentile(std::vector<double> &values, double percentile) {
+    if (values.empty())
+        return 0;
+    auto index = static_cast<std::size_t>(percentile / 100.0 * static_cast<double>(values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + static_cast<long>(index), values.end());
+    return values[index];
+}
+
+std::string GameServer::statsLine() {
+    std::vector<double> copy;
+    {
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        copy = latencies;
+    }
+    std::size_t queued;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queued = queue.size();
+    }
+    std::ostringstream out;
+    out << "stats sessions=" << sessions.size() << " queued=" << queued << " moves=" << copy.size();
+    out.precision(3);
+    out << std::fixed << " p50_ms=" << percentile(copy, 50) << " p99_ms=" << percentile(copy, 99);
+    return out.str();
+}
+
+void GameServer::handleLine(const std::shared_ptr<Session> &session, const std::string &line) {
+    std::istringstream in(line);
+    std::string command;
+    in >> command;
+    if (command.empty())
+        return;
+    if (command == "stats") {
+        std::string stats = statsLine();
+        std::lock_guard<std::mutex> lock(session->mutex);
+        session->send(stats);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(session->mutex);
+    if (session->searching && (command == "new" || command == "move" || command == "go")) {
+        session->send("error the AI is thinking");
+        return;
+    }
+    if (command == "new") {
+        std::string side;
+        in >> side;
+        if (side != "X" && side != "O") {
+            session->send("error usage: new <X|O> [depth] [ai_time_ms]");
+            return;
+        }
+        int depth = options.depth;
+        long long timeMs = -1;
+        if (!(in >> depth))
+            depth = options.depth;
+        if (!(in >> timeMs))
+            timeMs = -1;
+        session->started = true;
+        session->human = side[0];
+        session->ai = (side[0] == PLAYER_X) ? PLAYER_O : PLAYER_X;
+        session->toMove = PLAYER_X;
+        session->depth = std::max(1, depth);
+        session->aiTimeLeftMs = timeMs;
+        BoardHelper::initBoard(session->board);
+        session->send("ok");
+        if (session->toMove == session->ai)
+            scheduleAiMove(session);
+        else
+            session->send("turn");
+    } else if (command == "board") {
+        if (!session->started) {
+            session->send("error no game, use new");
+            return;
+        }
+        for (const auto &row: session->board)
+            session->send(std::string(row.begin(), row.end()));
+    } else if (command == "move") {
+        if (!session->started || session->toMove != session->human) {
+            session->send("error not your turn");
+            return;
+        }
+        Position move;
+        try {
+            in >> move;
+        } catch (const InvalidPositionFormatException &e) {
+            session->send(std::string("error ") + e.what());
+            return;
+        }
+        if (!BoardHelper::isValidMove(session->board, move, session->human)) {
+            session->send("error invalid move");
+            return;
+        }
+        BoardHelper::playMove(session->board, move, session->human);
+        session->send("ok");
+        if (!BoardHelper::switchPlayer(session->board, session->toMove)) {
+            session->started = false;
+            session->send("end " + std::to_string(scoreX(session->board)));
+        } else if (session->toMove == session->ai) {
+            scheduleAiMove(session);
+        } else {
+            session->send("turn"); // the AI has to pass
+        }
+    } else if (command == "go") {
+        // asks again for an AI move the server was too busy to start
+        if (!session->started || session->toMove != session->ai) {
+            session->send("error not the AI's turn");
+            return;
+        }
+        scheduleAiMove(session);
+    } else if (command == "quit") {
+        session->send("bye");
+        session->closed = true;
+    } else {
+        session->send("error unknown command " + command);
+    }
+}
+
+void GameServer::scheduleAiMove(const std::shared_ptr<Session> &session) {
+    // called with the session locked
+    std::unique_lock<std::mutex> lock(queueMutex);
+    if (queue.size() >= options.maxQueuedSearches) {
+        lock.unlock();
+        session->send("error server busy, send go to retry"); // the AI still has to move
+        return;
+    }
+    session->searching = true;
+    session->stopSource = StopSource();
+    session->searchStart = std::chrono::steady_clock::now();
+    if (session->aiTimeLeftMs >= 0) {
+        // spread the remaining time over the moves the AI still has to play
+        long long movesLeft = (64 - BoardHelper::countPiecesTotal(session->board)) / 2 + 1;
+        session->deadline = session->searchStart + std::chrono::milliseconds(session->aiTimeLeftMs / movesLeft);
+    }
+    queue.push_back(SearchJob{session, session->board, session->ai, session->depth, session->searchStart});
+    lock.unlock();
+    queueCondition.notify_one();
+}
+
+void GameServer::workerLoop() {
+    while (true) {
+        SearchJob job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (stopping)
+                return;
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+        StopToken stopToken;
+        {
+            std::lock_guard<std::mutex> lock(job.session->mutex);
+            if (job.session->closed)
+                continue;
+            if (!job.session->table)
+                job.session->table = std::make_unique<TranspositionTable>(options.tableMegabytes);
+            stopToken = job.session->stopSource.getToken();
+        }
+        SearchContext context(stopToken);
+        Position move = Solver(context, job.session->table.get()).search(job.board, job.player, job.depth);
+        if (!context.hasBestMove()) {
+            // stopped before any root move was searched: any legal move beats losing on time
+            std::vector<Position> moves = BoardHelper::getAllPossibleMoves(job.board, job.player);
+            if (!moves.empty())
+                move = moves.front();
+        }
+        finishAiMove(job, move);
+    }
+}
+
+void GameServer::finishAiMove(const SearchJob &job, Position move) {
+    auto now = std::chrono::steady_clock::now();
+    Session &session = *job.session;
+    std::lock_guard<std::mutex> lock(session.mutex);
+    session.searching = false;
+    if (session.closed)
+        return;
+    {
+        std::lock_guard<std::mutex> latencyLock(latencyMutex);
+        latencies.push_back(std::chrono::duration<double, std::milli>(now - job.queuedAt).count());
+    }
+    if (session.aiTimeLeftMs >= 0) {
+        session.aiTimeLeftMs -= std::chrono::duration_cast<std::chrono::milliseconds>(now - session.searchStart).count();
+        if (session.aiTimeLeftMs < 0) {
+            session.started = false;
+            session.send("end timeout");
+            return;
+        }
+    }
+    BoardHelper::playMove(session.board, move, session.ai);
+    std::ostringstream line;
+    line << "ai " << move;
+    session.send(line.str());
+    if (!BoardHelper::switchPlayer(session.board, session.toMove)) {
+        session.started = false;
+        session.send("end " + std::to_string(scoreX(session.board)));
+    } else if (session.toMove == session.ai) {
+        scheduleAiMove(job.session); // the human has to pass
+    } else {
+        session.send("turn");
+    }
+}
+
+void GameServer::checkClocks() {
+    auto now = std::chrono::steady_clock::now();
+    for (auto &[fd, session]: sessions) {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        if (session->searching && session->aiTimeLeftMs >= 0 && now >= session->deadline)
+            session->stopSource.requestStop();
+    }
+}
+
+void GameServer::closeSession(int fd) {
+    auto it = sessions.find(fd);
+    if (it == sessions.end())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(it->second->mutex);
+        it->second->closed = true;
+        it->second->stopSource.requestStop(); // the client will never read the answer
+    }
+#if !defined(_WIN32)
+    ::close(fd);
+#endif
+    sessions.erase(it);
+}
+
+#if !defined(_WIN32)
+
+int GameServer::run() {
+    int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "socket: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (options.socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path too long: " << options.socketPath << std::endl;
+        ::close(listenFd);
+        return 1;
+    }
+    std::strcpy(address.sun_path, options.socketPath.c_str());
+    ::unlink(options.socketPath.c_str());
+    if (::bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+        ::listen(listenFd, 128) < 0) {
+        std::cerr << "bind/listen " << options.socketPath << ": " << std::strerror(errno) << std::endl;
+        ::close(listenFd);
+        return 1;
+    }
+    std::cout << "Listening on " << options.socketPath << " with " << workers.size() << " workers" << std::endl;
+
+    std::vector<pollfd> fds;
+    while (!stopping) {
+        fds.clear();
+        fds.push_back({listenFd, POLLIN, 0});
+        std::vector<int> overflowing;
+        for (auto &[fd, session]: sessions) {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            if (session->output.size() > MAX_OUTPUT_BYTES)
+                overflowing.push_back(fd);
+            else
+                fds.push_back({fd, static_cast<short>(session->output.empty() ? POLLIN : POLLIN | POLLOUT), 0});
+        }
+        for (int fd: overflowing)
+            closeSession(fd);
+        int ready = ::poll(fds.data(), fds.size(), POLL_INTERVAL_MS);
+        checkClocks();
+        if (ready <= 0)
+            continue;
+
+        if (fds[0].revents & POLLIN) {
+            int clientFd = ::accept(listenFd, nullptr, nullptr);
+            // never block the I/O thread, nor a worker holding a session lock, on a slow client
+            if (clientFd >= 0 && ::fcntl(clientFd, F_SETFL, ::fcntl(clientFd, F_GETFL) | O_NONBLOCK) == 0)
+                sessions[clientFd] = std::make_shared<Session>(clientFd);
+            else if (clientFd >= 0)
+                ::close(clientFd);
+        }
+        for (std::size_t i = 1; i < fds.size(); i++) {
+            std::shared_ptr<Session> session = sessions[fds[i].fd];
+            if (fds[i].revents & POLLOUT) {
+                std::lock_guard<std::mutex> lock(session->mutex);
+                session->flush();
+            }
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+            char buffer[4096];
+            ssize_t n = ::recv(fds[i].fd, buffer, sizeof(buffer), 0);
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                continue;
+            if (n <= 0) {
+                closeSession(fds[i].fd);
+                continue;
+            }
+            session->input.append(buffer, static_cast<std::size_t>(n));
+            std::size_t end;
+            while ((end = session->input.find('\n')) != std::string::npos) {
+                std::string line = session->input.substr(0, end);
+                session->input.erase(0, end + 1);
+                handleLine(session, line);
+            }
+            bool closed = session->input.size() > MAX_INPUT_BYTES;
+            {
+                std::lock_guard<std::mutex> lock(session->mutex);
+                closed = closed || session->closed;
+            }
+            if (closed)
+                closeSession(fds[i].fd);
+        }
+    }
+
+    std::cout << statsLine() << std::endl;
+    ::close(listenFd);
+    ::unlink(options.socketPath.c_str());
+    return 0;
+}
+
+/**
+ * Reads one line from a socket, one byte at a time: the load test is the bottleneck of nothing.
+ */
+static bool readLine(int fd, std::string &line) {
+    line.clear();
+    char c;
+    while (true) {
+        ssize_t n = ::recv(fd, &c, 1, 0);
+        if (n <= 0)
+            return false;
+        if (c == '\n')
+            return true;
+        line += c;
+    }
+}
+
+static bool sendLine(int fd, const std::string &line) {
+    std::string data = line + "\n";
+    return ::send(fd, data.data(), data.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(data.size());
+}
+
+int GameServer::runLoadTest(const std::string &socketPath, int sessionCount, int games) {
+    std::mutex resultMutex;
+    std::vector<double> clientLatencies;
+    std::atomic<int> failures{0};
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> clients;
+    for (int c = 0; c < sessionCount; c++) {
+        clients.emplace_back([&, c]() {
+            int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+            if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+                failures++;
+                if (fd >= 0)
+                    ::close(fd);
+                return;
+            }
+            std::mt19937 rng(static_cast<unsigned int>(c));
+            std::vector<double> mine;
+            std::string line;
+            for (int g = 0; g < games; g++) {
+                char human = (g + c) % 2 ? PLAYER_O : PLAYER_X;
+                char ai = (human == PLAYER_X) ? PLAYER_O : PLAYER_X;
+                std::vector<std::vector<char>> board;
+                BoardHelper::initBoard(board);
+                auto requestTime = std::chrono::steady_clock::now();
+                sendLine(fd, std::string("new ") + human);
+                bool over = false;
+                while (!over && readLine(fd, line)) {
+                    unsigned int row, col;
+                    if (std::sscanf(line.c_str(), "ai {row=%u, col=%u}", &row, &col) == 2) {
+                        auto now = std::chrono::steady_clock::now();
+                        mine.push_back(std::chrono::duration<double, std::milli>(now - requestTime).count());
+                        requestTime = now;
+                        BoardHelper::playMove(board, Position(row, col), ai);
+                    } else if (line == "turn") {
+                        std::vector<Position> moves = BoardHelper::getAllPossibleMoves(board, human);
+                        Position move = moves[rng() % moves.size()];
+                        BoardHelper::playMove(board, move, human);
+                        std::ostringstream request;
+                        request << "move {" << move.getRow() << "," << move.getCol() << "}";
+                        requestTime = std::chrono::steady_clock::now();
+                        sendLine(fd, request.str());
+                    } else if (line.rfind("end", 0) == 0) {
+                        over = true;
+                    } else if (line.rfind("error server busy", 0) == 0) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+                        sendLine(fd, "go");
+                    } else if (line.rfind("error", 0) == 0) {
+                        failures++;
+                        over = true;
+                    }
+                }
+                if (!over)
+                    break; // connection lost
+            }
+            sendLine(fd, "quit");
+            ::close(fd);
+            std::lock_guard<std::mutex> lock(resultMutex);
+            clientLatencies.insert(clientLatencies.end(), mine.begin(), mine.end());
+        });
+    }
+    for (std::thread &client: clients)
+        client.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout.precision(3);
+    std::cout << std::fixed << "sessions=" << sessionCount << " games=" << sessionCount * games
+              << " ai_moves=" << clientLatencies.size() << " seconds=" << seconds
+              << " p50_ms=" << percentile(clientLatencies, 50) << " p99_ms=" << percentile(clientLatencies, 99)
+              << " failures=" << failures << std::endl;
+    return failures == sessionCount ? 1 : 0;
+}
+
+#else
+
+int GameServer::run() {
+    std::cerr << "The server needs Unix domain sockets, which this platform does not provide." << std::endl;
+    return 1;
+}
+
+int GameServer::runLoadTest(const std::string &, int, int) {
+    std::cerr << "The server needs Unix domain sockets, which this platform does not provide." << std::endl;
+    return 1;
+}
+
+#endif
\ No newline at end of file
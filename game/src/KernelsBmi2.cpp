@@ -0,0 +1,25 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/Kernels.hpp"
+
+namespace CpuDispatch {
+
+/** Kernels compiled with -mbmi2: flips computed per line through PEXT and PDEP. */
+extern const Kernels BMI2_KERNELS = KernelImpl::makeKernels(ISA_BMI2, "bmi2");
+
+} // namespace CpuDispatch
\ No newline at end of file
@@ -0,0 +1,161 @@
+
+#include "../include/Match.hpp"
+#include "../include/Bitboard.hpp"
+#include "../include/ThreadPool.hpp"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <mutex>
+#include <random>
+
+constexpr char PLAYER_X = 'X';
+constexpr char PLAYER_O = 'O';
+constexpr int BOARD_SIZE = 8;
+
+/** Returns the n-th set square of a mask, n counted from the lowest square. */
+static Square nthSquare(std::uint64_t mask, int n) {
+    while (n-- > 0)
+        mask &= mask - 1;
+    return Bitboard::firstSquare(mask);
+}
+
+/**
+ * One side of a game, with its own table so that the two configurations share nothing.
+ */
+struct Engine {
+    TranspositionTable table;
+    SearchContext context;
+    Solver solver;
+
+    Engine(std::size_t tableMegabytes, const SearchOptions &options)
+        : table(tableMegabytes), solver(context, &table) {
+        solver.setOptions(options);
+    }
+};
+
+/**
+ * @brief Searches the move of an engine, at the fixed depth or for the time per move.
+ * @param board The position, the player to move playing PLAYER_X.
+ * @param stats Totals of the engine, updated with the depth reached and the nodes visited.
+ * @return The move.
+ */
+static Square searchMove(Engine &engine, const std::vector<std::vector<char>> &board, const MatchOptions &options,
+                         MatchEngineStats &stats) {
+    Square best = NO_SQUARE;
+    int reached = 0;
+    if (options.depth > 0) {
+        best = toSquare(engine.solver.analyze(board, PLAYER_X, options.depth, 1).front().move);
+        reached = options.depth;
+        stats.nodes += engine.context.getNodeCount();
+    } else {
+        engine.context.setDeadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(options.timeMs));
+        // past the end of the game, deeper iterations search the same tree again
+        int maxDepth = BOARD_SIZE * BOARD_SIZE - BoardHelper::countPiecesTotal(board) + 2;
+        for (int depth = 1; depth <= maxDepth; depth++) {
+            std::vector<MoveAnalysis> ranking = engine.solver.analyze(board, PLAYER_X, depth, 1);
+            stats.nodes += engine.context.getNodeCount();
+            if (engine.context.stopRequested()) {
+                // only an iteration aborted before the first one completed is worth its partial result
+                if (best == NO_SQUARE && !ranking.empty())
+                    best = toSquare(ranking.front().move);
+                break;
+            }
+            best = toSquare(ranking.front().move);
+            reached = depth;
+        }
+        engine.context.clearDeadline();
+        if (best == NO_SQUARE) { // not even one move searched in time
+            MoveList moves;
+            BoardHelper::getAllPossibleMoves(board, PLAYER_X, moves);
+            best = moves[0];
+        }
+    }
+    stats.moves++;
+    stats.depthSum += reached;
+    return best;
+}
+
+MatchResult Match::run(const MatchOptions &options, std::ostream &out) {
+    std::vector<std::vector<char>> initialBoard;
+    BoardHelper::initBoard(initialBoard);
+    const Bitboard initial = Bitboard::fromBoard(initialBoard, PLAYER_X);
+
+    ThreadPool pool(options.threads);
+    out << "threads   : " << pool.size() << std::endl;
+    if (options.depth > 0)
+        out << "depth     : " << options.depth << std::endl;
+    else
+        out << "time/move : " << options.timeMs << " ms" << std::endl;
+
+    MatchResult result;
+    std::mutex resultMutex;
+    TaskGroup group;
+    for (int game = 0; game < 2 * options.openings; game++) {
+        pool.submit(group, [&, game]() {
+            const int opening = game / 2;
+            const int candidateSide = game % 2; // 0: the candidate moves first
+            std::mt19937_64 random(options.seed + static_cast<std::uint64_t>(opening));
+            Engine engines[2] = {Engine(options.tableMegabytes, options.candidate),
+                                 Engine(options.tableMegabytes, options.reference)};
+            MatchEngineStats stats[2];
+            std::vector<std::vector<char>> board;
+
+            Bitboard position = initial;
+            int side = 0; // side of the player to move, 0 for the first player
+            for (int ply = 0;; ply++) {
+                if (position.getMoves() == 0) {
+                    position.pass();
+                    side ^= 1;
+                    if (position.getMoves() == 0)
+                        break;
+                }
+                std::uint64_t moves = position.getMoves();
+                Square move;
+                if (ply < options.randomPlies) {
+                    move = nthSquare(moves, static_cast<int>(random() % Bitboard::popCount(moves)));
+                } else {
+                    int engine = side == candidateSide ? 0 : 1;
+                    position.toBoard(board, PLAYER_X);
+                    move = searchMove(engines[engine], board, options, stats[engine]);
+                }
+                position.play(move, position.getFlips(move));
+                side ^= 1;
+            }
+            int discs = Bitboard::popCount(position.player) - Bitboard::popCount(position.opponent);
+            if (side != candidateSide)
+                discs = -discs;
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            (discs > 0 ? result.wins : discs < 0 ? result.losses : result.draws)++;
+            result.discs += discs;
+            for (int engine = 0; engine < 2; engine++) {
+                MatchEngineStats &total = engine == 0 ? result.candidate : result.reference;
+                total.moves += stats[engine].moves;
+                total.depthSum += stats[engine].depthSum;
+                total.nodes += stats[engine].nodes;
+            }
+            out << "game " << std::setw(4) << game + 1 << ": opening " << std::setw(3) << opening + 1 << "  candidate "
+                << (candidateSide == 0 ? PLAYER_X : PLAYER_O) << "  discs " << std::showpos << std::setw(3) << discs
+                << std::noshowpos << std::endl;
+        });
+    }
+    pool.wait(group);
+
+    int games = result.wins + result.draws + result.losses;
+    double score = games > 0 ? (result.wins + 0.5 * result.draws) / games : 0.5;
+    auto averageDepth = [](const MatchEngineStats &stats) {
+        return stats.moves > 0 ? static_cast<double>(stats.depthSum) / static_cast<double>(stats.moves) : 0.0;
+    };
+    out << "==========================" << std::endl;
+    out << "games     : " << games << std::endl;
+    out << "candidate : +" << result.wins << " =" << result.draws << " -" << result.losses << std::endl;
+    out << "score     : " << std::fixed << std::setprecision(1) << 100 * score << " %" << std::endl;
+    if (score > 0 && score < 1)
+        out << "elo       : " << std::showpos << 400 * std::log10(score / (1 - score)) << std::noshowpos << std::endl;
+    out << "discs     : " << std::showpos << std::setprecision(2)
+        << (games > 0 ? static_cast<double>(result.discs) / games : 0.0) << std::noshowpos << " per game" << std::endl;
+    out << "depth     : candidate " << averageDepth(result.candidate) << "  reference "
+        << averageDepth(result.reference) << std::defaultfloat << std::endl;
+    out << "nodes     : candidate " << result.candidate.nodes << "  reference " << result.reference.nodes << std::endl;
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/MctsSolver.hpp"
+#include <algorithm>
+#include <cmath>
+
+constexpr int MAX_PATH = 128;       // 60 moves and the passes between them
+constexpr int CLOCK_CHECK_MASK = 63; // the clock is read every 64 playouts
+
+MctsSolver::MctsSolver(ThreadPool *pool, std::size_t arenaNodes, double exploration)
+    : pool(pool), exploration(exploration), capacity(arenaNodes < 1 ? 1 : arenaNodes),
+      arena(std::make_unique<Node[]>(capacity)) {}
+
+MctsResult MctsSolver::search(const Bitboard &board, std::chrono::milliseconds budget,
+                              unsigned long long maxPlayouts, const StopToken &stopToken) {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + budget;
+    Node &root = arena[0];
+    root.visits.store(0, std::memory_order_relaxed);
+    root.reward.store(0, std::memory_order_relaxed);
+    root.virtualLoss.store(0, std::memory_order_relaxed);
+    root.state.store(UNEXPANDED, std::memory_order_relaxed);
+    root.childCount = 0;
+    used = 1;
+    playouts = 0;
+
+    if (pool) {
+        TaskGroup group;
+        for (unsigned int thread = 0; thread < pool->size(); thread++)
+            pool->submit(group, [&, thread]() { runPlayouts(board, deadline, maxPlayouts, stopToken, thread + 1); });
+        pool->wait(group);
+    } else {
+        runPlayouts(board, deadline, maxPlayouts, stopToken, 1);
+    }
+
+    MctsResult result;
+    result.playouts = playouts;
+    result.nodes = std::min(used.load(), capacity);
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (root.state.load(std::memory_order_acquire) == EXPANDED) {
+        const Node *best = nullptr;
+        for (std::uint8_t i = 0; i < root.childCount; i++) {
+            const Node &child = arena[root.firstChild + i];
+            if (!best || child.visits > best->visits)
+                best = &child;
+        }
+        if (best) {
+            result.bestMove = best->move;
+            if (best->visits > 0)
+                result.winRate = best->reward / (2.0 * best->visits);
+        }
+    }
+    return result;
+}
+
+MctsResult MctsSolver::search(const std::vector<std::vector<char>> &board, char player,
+                              std::chrono::milliseconds budget) {
+    return search(Bitboard::fromBoard(board, player), budget);
+}
+
+void MctsSolver::runPlayouts(const Bitboard &root, std::chrono::steady_clock::time_point deadline,
+                             unsigned long long maxPlayouts, const StopToken &stopToken, std::uint64_t seed) {
+    std::uint64_t random = seed * 0x9E3779B97F4A7C15ULL;
+    Node *path[MAX_PATH];
+    for (unsigned long long local = 0;; local++) {
+        if ((local & CLOCK_CHECK_MASK) == 0 &&
+            (stopToken.stopRequested() || std::chrono::steady_clock::now() >= deadline))
+            return;
+        if (playouts.fetch_add(1, std::memory_order_relaxed) >= maxPlayouts && maxPlayouts != 0) {
+            playouts.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // selection, with a virtual loss on every node taken
+        Bitboard board = root;
+        Node *node = &arena[0];
+        int depth = 0;
+        path[depth++] = node;
+        while (node->state.load(std::memory_order_acquire) == EXPANDED && node->childCount > 0) {
+            node = &selectChild(*node);
+            node->virtualLoss.fetch_add(1, std::memory_order_relaxed);
+            if (node->move == NO_SQUARE)
+                board.pass();
+            else
+                board.play(node->move, board.getFlips(node->move));
+            path[depth++] = node;
+        }
+        if (node->state.load(std::memory_order_relaxed) == UNEXPANDED)
+            expand(*node, board);
+
+        // simulation and backpropagation, the reward alternating between the players
+        std::uint32_t reward = 2 - playout(board, random);
+        while (depth-- > 0) {
+            path[depth]->reward.fetch_add(reward, std::memory_order_relaxed);
+            path[depth]->visits.fetch_add(1, std::memory_order_relaxed);
+            if (depth > 0)
+                path[depth]->virtualLoss.fetch_sub(1, std::memory_order_relaxed);
+            reward = 2 - reward;
+        }
+    }
+}
+
+void MctsSolver::expand(Node &node, const Bitboard &board) {
+    std::uint8_t expected = UNEXPANDED;
+    if (!node.state.compare_exchange_strong(expected, EXPANDING, std::memory_order_acq_rel))
+        return; // another thread is expanding it
+
+    std::uint64_t moves = board.getMoves();
+    int count = Bitboard::popCount(moves);
+    if (count == 0) {
+        Bitboard passed = board;
+        passed.pass();
+        if (passed.getMoves() != 0)
+            count = 1; // a single pass child, the game is over otherwise
+    }
+    std::size_t first = used.fetch_add(static_cast<std::size_t>(count), std::memory_order_relaxed);
+    if (first + static_cast<std::size_t>(count) > capacity)
+        return; // arena full: the node stays a leaf for good
+    for (int i = 0; i < count; i++) {
+        Node &child = arena[first + static_cast<std::size_t>(i)];
+        child.visits.store(0, std::memory_order_relaxed);
+        child.reward.store(0, std::memory_order_relaxed);
+        child.virtualLoss.store(0, std::memory_order_relaxed);
+        child.state.store(UNEXPANDED, std::memory_order_relaxed);
+        child.childCount = 0;
+        child.move = moves ? Bitboard::firstSquare(moves) : NO_SQUARE;
+        moves &= moves - 1;
+    }
+    node.firstChild = static_cast<std::uint32_t>(first);
+    node.childCount = static_cast<std::uint8_t>(count);
+    node.state.store(EXPANDED, std::memory_order_release);
+}
+
+MctsSolver::Node &MctsSolver::selectChild(const Node &node) const {
+    double logVisits = std::log(static_cast<double>(node.visits.load(std::memory_order_relaxed) +
+                                                    node.virtualLoss.load(std::memory_order_relaxed)) + 1.0);
+    Node *best = nullptr;
+    double bestBound = -1;
+    for (std::uint8_t i = 0; i < node.childCount; i++) {
+        Node &child = arena[node.firstChild + i];
+        // a virtual loss counts as a visit without reward
+        std::uint32_t visits = child.visits.load(std::memory_order_relaxed) +
+                               child.virtualLoss.load(std::memory_order_relaxed);
+        if (visits == 0)
+            return child;
+        double bound = child.reward.load(std::memory_order_relaxed) / (2.0 * visits) +
+                       exploration * std::sqrt(logVisits / visits);
+        if (bound > bestBound) {
+            bestBound = bound;
+            best = &child;
+        }
+    }
+    return *best;
+}
+
+std::uint32_t MctsSolver::playout(Bitboard board, std::uint64_t &random) {
+    bool swapped = false; // true if board is from the point of view of the opponent of the starting player
+    while (true) {
+        std::uint64_t moves = board.getMoves();
+        if (moves == 0) {
+            board.pass();
+            swapped = !swapped;
+            moves = board.getMoves();
+            if (moves == 0)
+                break;
+        }
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        auto index = static_cast<int>(((random & 0xFFFFFFFFULL) * Bitboard::popCount(moves)) >> 32);
+        while (index-- > 0)
+            moves &= moves - 1;
+        Square move = Bitboard::firstSquare(moves);
+        board.play(move, board.getFlips(move));
+        swapped = !swapped;
+    }
+    int score = swapped ? -board.getFinalScore() : board.getFinalScore();
+    return score > 0 ? 2 : (score == 0 ? 1 : 0);
+}
\ No newline at end of file
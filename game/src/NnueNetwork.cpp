@@ -0,0 +1,168 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/NnueNetwork.hpp"
+#include "../include/CpuDispatch.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+
+constexpr char PLAYER_X = 'X';
+constexpr char PLAYER_O = 'O';
+constexpr int BOARD_SIZE = 8;
+constexpr int CLIP_MAX = 127;
+
+/** Adds (sign 1) or subtracts (sign -1) a first layer row to an accumulator, wrapping like the SIMD adds. */
+static inline void addRow(std::int16_t *accumulator, const std::int16_t *row, int sign) {
+    CpuDispatch::kernels().addRow(accumulator, row, NnueNetwork::HIDDEN, sign);
+}
+
+/** Clips accumulator values to [0, CLIP_MAX]. */
+static inline void clip(const std::int16_t *values, std::uint8_t *out) {
+    CpuDispatch::kernels().clip(values, out, NnueNetwork::HIDDEN);
+}
+
+/** Dot product of clipped activations and 8-bit weights; size is a multiple of 32. */
+static inline std::int32_t dot(const std::uint8_t *input, const std::int8_t *weights, int size) {
+    return CpuDispatch::kernels().dotProduct(input, weights, size);
+}
+
+/** Reads little-endian values from a byte buffer. */
+template<typename T>
+static void readLittleEndian(const unsigned char *&in, T *out, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+        std::uint64_t value = 0;
+        for (std::size_t b = 0; b < sizeof(T); b++)
+            value |= static_cast<std::uint64_t>(in[b]) << (8 * b);
+        out[i] = static_cast<T>(value);
+        in += sizeof(T);
+    }
+}
+
+/** Writes values drawn uniformly from [low, high] in little-endian order. */
+template<typename T>
+static void writeRandomValues(std::vector<unsigned char> &out, std::mt19937_64 &random, std::size_t count,
+                              int low, int high) {
+    std::uniform_int_distribution<int> distribution(low, high);
+    for (std::size_t i = 0; i < count; i++) {
+        auto value = static_cast<std::uint64_t>(static_cast<T>(distribution(random)));
+        for (std::size_t b = 0; b < sizeof(T); b++)
+            out.push_back(static_cast<unsigned char>(value >> (8 * b)));
+    }
+}
+
+NnueNetwork::NnueNetwork(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("cannot open " + path);
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    constexpr std::size_t expected = sizeof(MAGIC) + INPUTS * HIDDEN * 2 + HIDDEN * 2 + DENSE * 2 * HIDDEN +
+                                     DENSE * 4 + DENSE + 4;
+    if (bytes.size() != expected || std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0)
+        throw std::runtime_error(path + " is not a network weight file");
+
+    const unsigned char *in = bytes.data() + sizeof(MAGIC);
+    readLittleEndian(in, &inputWeights[0][0], INPUTS * HIDDEN);
+    readLittleEndian(in, inputBiases, HIDDEN);
+    readLittleEndian(in, &denseWeights[0][0], DENSE * 2 * HIDDEN);
+    readLittleEndian(in, denseBiases, DENSE);
+    readLittleEndian(in, outputWeights, DENSE);
+    readLittleEndian(in, &outputBias, 1);
+
+    checksum = 0xCBF29CE484222325ULL; // FNV-1a
+    for (unsigned char byte: bytes)
+        checksum = (checksum ^ byte) * 0x100000001B3ULL;
+}
+
+void NnueNetwork::refresh(Accumulator &accumulator, const std::vector<std::vector<char>> &board) const {
+    for (auto &values: accumulator.values)
+        std::copy(std::begin(inputBiases), std::end(inputBiases), values);
+    for (int row = 0; row < BOARD_SIZE; row++)
+        for (int col = 0; col < BOARD_SIZE; col++)
+            if (board[row][col] == PLAYER_X || board[row][col] == PLAYER_O)
+                updateDisc(accumulator, board[row][col] == PLAYER_X ? 0 : 1,
+                           static_cast<Square>(row * BOARD_SIZE + col), false, 1);
+}
+
+void NnueNetwork::applyMove(Accumulator &accumulator, const MoveUndo &undo, char mover) const {
+    int color = (mover == PLAYER_X) ? 0 : 1;
+    updateDisc(accumulator, color, undo.square, false, 1);
+    for (int i = 0; i < undo.flipCount; i++)
+        updateDisc(accumulator, color, undo.flipped[i], true, 1);
+}
+
+void NnueNetwork::undoMove(Accumulator &accumulator, const MoveUndo &undo, char mover) const {
+    int color = (mover == PLAYER_X) ? 0 : 1;
+    updateDisc(accumulator, color, undo.square, false, -1);
+    for (int i = 0; i < undo.flipCount; i++)
+        updateDisc(accumulator, color, undo.flipped[i], true, -1);
+}
+
+void NnueNetwork::updateDisc(Accumulator &accumulator, int color, Square square, bool flip, int sign) const {
+    const std::int16_t *own = inputWeights[square];
+    const std::int16_t *opponent = inputWeights[BOARD_SIZE * BOARD_SIZE + square];
+    addRow(accumulator.values[color], own, sign);
+    addRow(accumulator.values[1 - color], opponent, sign);
+    if (flip) { // the disc leaves the other player
+        addRow(accumulator.values[color], opponent, -sign);
+        addRow(accumulator.values[1 - color], own, -sign);
+    }
+}
+
+int NnueNetwork::evaluate(const Accumulator &accumulator, char player) const {
+    int color = (player == PLAYER_X) ? 0 : 1;
+    alignas(32) std::uint8_t input[2 * HIDDEN];
+    clip(accumulator.values[color], input);
+    clip(accumulator.values[1 - color], input + HIDDEN);
+
+    alignas(32) std::uint8_t dense[DENSE];
+    for (int j = 0; j < DENSE; j++)
+        dense[j] = static_cast<std::uint8_t>(
+                std::clamp((denseBiases[j] + dot(input, denseWeights[j], 2 * HIDDEN)) >> DENSE_SHIFT, 0, CLIP_MAX));
+    return (outputBias + dot(dense, outputWeights, DENSE)) >> OUTPUT_SHIFT;
+}
+
+int NnueNetwork::evaluate(const std::vector<std::vector<char>> &board, char player) const {
+    Accumulator accumulator;
+    refresh(accumulator, board);
+    return evaluate(accumulator, player);
+}
+
+void NnueNetwork::writeRandom(const std::string &path, std::uint64_t seed) {
+    std::mt19937_64 random(seed);
+    std::vector<unsigned char> bytes(std::begin(MAGIC), std::end(MAGIC));
+    // 64 discs of at most 32 each on top of the bias stay far from the int16 limits
+    writeRandomValues<std::int16_t>(bytes, random, INPUTS * HIDDEN, -32, 32);
+    writeRandomValues<std::int16_t>(bytes, random, HIDDEN, 0, 64);
+    writeRandomValues<std::int8_t>(bytes, random, DENSE * 2 * HIDDEN, -16, 16);
+    writeRandomValues<std::int32_t>(bytes, random, DENSE, -256, 256);
+    writeRandomValues<std::int8_t>(bytes, random, DENSE, -64, 64);
+    writeRandomValues<std::int32_t>(bytes, random, 1, -256, 256);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    file.close();
+    if (!file)
+        throw std::runtime_error("cannot write " + path);
+}
+
+const char *NnueNetwork::kernelName() {
+    return CpuDispatch::kernels().name;
+}
\ No newline at end of file
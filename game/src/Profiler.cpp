@@ -0,0 +1,254 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/Profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define PROFILER_HAS_RDTSC 1
+#endif
+
+constexpr int BUCKET_COUNT = 64; // bucket b holds the durations d with floor(log2(d)) == b
+constexpr int NO_NODE = -1;
+
+/** Distribution of the durations of one probe. */
+struct ProbeHistogram {
+    std::uint64_t calls = 0;
+    std::uint64_t ticks = 0;
+    std::uint64_t buckets[BUCKET_COUNT] = {};
+
+    void add(std::uint64_t elapsed) {
+        calls++;
+        ticks += elapsed;
+        int bucket = 0;
+        while (bucket + 1 < BUCKET_COUNT && (elapsed >> (bucket + 1)) != 0)
+            bucket++;
+        buckets[bucket]++;
+    }
+
+    void merge(const ProbeHistogram &other) {
+        calls += other.calls;
+        ticks += other.ticks;
+        for (int b = 0; b < BUCKET_COUNT; b++)
+            buckets[b] += other.buckets[b];
+    }
+
+    /** Upper bound of the bucket holding the given share of the calls. */
+    [[nodiscard]] std::uint64_t percentile(double share) const {
+        std::uint64_t seen = 0;
+        for (int b = 0; b < BUCKET_COUNT; b++) {
+            seen += buckets[b];
+            if (seen > 0 && static_cast<double>(seen) >= share * static_cast<double>(calls))
+                return (std::uint64_t{2} << b) - 1;
+        }
+        return 0;
+    }
+};
+
+/** One stack of probes: a probe entered from the stack of its parent node. */
+struct ProbeCallNode {
+    Profiler::Probe probe;
+    int parent;
+    int children[Profiler::PROBE_COUNT];
+    std::uint64_t calls = 0;
+    std::uint64_t ticks = 0;
+
+    ProbeCallNode(Profiler::Probe probe, int parent) : probe(probe), parent(parent) {
+        for (int &child: children)
+            child = NO_NODE;
+    }
+};
+
+/** Call tree of probes; node 0 is the root, outside of any probe. */
+struct ProbeCallTree {
+    std::vector<ProbeCallNode> nodes{ProbeCallNode(Profiler::PROBE_COUNT, NO_NODE)};
+
+    int child(int parent, Profiler::Probe probe) {
+        if (nodes[parent].children[probe] == NO_NODE) {
+            nodes.emplace_back(probe, parent);
+            nodes[parent].children[probe] = static_cast<int>(nodes.size() - 1);
+        }
+        return nodes[parent].children[probe];
+    }
+
+    /** Adds the subtree of another tree at the given node of this one. */
+    void merge(int node, const ProbeCallTree &other, int otherNode) {
+        nodes[node].calls += other.nodes[otherNode].calls;
+        nodes[node].ticks += other.nodes[otherNode].ticks;
+        for (int p = 0; p < Profiler::PROBE_COUNT; p++)
+            if (other.nodes[otherNode].children[p] != NO_NODE)
+                merge(child(node, static_cast<Profiler::Probe>(p)), other, other.nodes[otherNode].children[p]);
+    }
+
+    /** Ticks spent in a node and not in its children. */
+    [[nodiscard]] std::uint64_t selfTicks(int node) const {
+        std::uint64_t self = nodes[node].ticks;
+        for (int child: nodes[node].children)
+            if (child != NO_NODE)
+                self -= std::min(self, nodes[child].ticks);
+        return self;
+    }
+};
+
+/** Records of one thread, written by that thread only. */
+struct ThreadProfile {
+    ProbeCallTree tree;
+    int current = 0;
+    ProbeHistogram histograms[Profiler::PROBE_COUNT];
+};
+
+static std::mutex registryMutex;
+static std::vector<std::unique_ptr<ThreadProfile>> registry; // kept after their threads exit
+
+static ThreadProfile &threadProfile() {
+    thread_local ThreadProfile *profile = nullptr;
+    if (!profile) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(std::make_unique<ThreadProfile>());
+        profile = registry.back().get();
+    }
+    return *profile;
+}
+
+/** Merges the records of every thread. */
+static void mergeProfiles(ProbeCallTree &tree, ProbeHistogram *histograms) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto &profile: registry) {
+        tree.merge(0, profile->tree, 0);
+        for (int p = 0; p < Profiler::PROBE_COUNT; p++)
+            histograms[p].merge(profile->histograms[p]);
+    }
+}
+
+/** Measures the tick rate of the cycle counter against steady_clock. */
+static double ticksPerMicrosecond() {
+    static const double rate = []() {
+        auto start = std::chrono::steady_clock::now();
+        std::uint64_t startTicks = Profiler::ticks();
+        while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20)) {
+        }
+        double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        return static_cast<double>(Profiler::ticks() - startTicks) / micros;
+    }();
+    return rate;
+}
+
+const char *Profiler::probeName(Probe probe) {
+    static const char *const NAMES[PROBE_COUNT] = {"search",          "move_generation", "flips",
+                                                   "evaluation",      "eval_disc_diff",  "eval_mobility",
+                                                   "eval_corner",     "eval_parity",     "eval_positional",
+                                                   "eval_edge_control"};
+    return probe < PROBE_COUNT ? NAMES[probe] : "root";
+}
+
+std::uint64_t Profiler::ticks() {
+#if defined(PROFILER_HAS_RDTSC)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+                    .count());
+#endif
+}
+
+void Profiler::enter(Probe probe) {
+    ThreadProfile &profile = threadProfile();
+    profile.current = profile.tree.child(profile.current, probe);
+}
+
+void Profiler::leave(std::uint64_t elapsed) {
+    ThreadProfile &profile = threadProfile();
+    ProbeCallNode &node = profile.tree.nodes[profile.current];
+    node.calls++;
+    node.ticks += elapsed;
+    profile.histograms[node.probe].add(elapsed);
+    profile.current = node.parent;
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto &profile: registry) {
+        profile->tree = ProbeCallTree();
+        profile->current = 0;
+        for (ProbeHistogram &histogram: profile->histograms)
+            histogram = ProbeHistogram();
+    }
+}
+
+void Profiler::printTable(std::ostream &out) {
+    ProbeCallTree tree;
+    ProbeHistogram histograms[PROBE_COUNT];
+    mergeProfiles(tree, histograms);
+
+    std::uint64_t selfTicks[PROBE_COUNT] = {};
+    std::uint64_t totalSelf = 0;
+    for (std::size_t node = 1; node < tree.nodes.size(); node++) {
+        std::uint64_t self = tree.selfTicks(static_cast<int>(node));
+        selfTicks[tree.nodes[node].probe] += self;
+        totalSelf += self;
+    }
+
+    double rate = ticksPerMicrosecond();
+    out << std::left << std::setw(18) << "probe" << std::right << std::setw(12) << "calls" << std::setw(14)
+        << "self_us" << std::setw(8) << "self%" << std::setw(12) << "mean_ticks" << std::setw(12) << "p50_ticks"
+        << std::setw(12) << "p99_ticks" << std::endl;
+    for (int p = 0; p < PROBE_COUNT; p++) {
+        const ProbeHistogram &histogram = histograms[p];
+        if (histogram.calls == 0)
+            continue;
+        out << std::left << std::setw(18) << probeName(static_cast<Probe>(p)) << std::right << std::setw(12)
+            << histogram.calls << std::setw(14) << static_cast<std::uint64_t>(selfTicks[p] / rate) << std::setw(8)
+            << std::fixed << std::setprecision(1) << 100.0 * selfTicks[p] / (totalSelf ? totalSelf : 1)
+            << std::defaultfloat << std::setw(12) << histogram.ticks / histogram.calls << std::setw(12)
+            << histogram.percentile(0.5) << std::setw(12) << histogram.percentile(0.99) << std::endl;
+    }
+    out << "(" << std::fixed << std::setprecision(1) << rate << std::defaultfloat
+        << " ticks/us; mean and percentiles include the nested probes, percentiles are log2 bucket bounds)"
+        << std::endl;
+}
+
+/** Prints the stacks under a node, depth first. */
+static void printStacks(const ProbeCallTree &tree, int node, const std::string &path, std::ostream &out) {
+    for (int child: tree.nodes[node].children) {
+        if (child == NO_NODE)
+            continue;
+        std::string childPath = path.empty() ? Profiler::probeName(tree.nodes[child].probe)
+                                             : path + ";" + Profiler::probeName(tree.nodes[child].probe);
+        if (std::uint64_t self = tree.selfTicks(child))
+            out << childPath << " " << self << "\n";
+        printStacks(tree, child, childPath, out);
+    }
+}
+
+void Profiler::printCollapsed(std::ostream &out) {
+    ProbeCallTree tree;
+    ProbeHistogram histograms[PROBE_COUNT];
+    mergeProfiles(tree, histograms);
+    printStacks(tree, 0, "", out);
+    out.flush();
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/SearchContext.hpp"
+
+bool SearchContext::hasBestMove() const {
+    std::lock_guard<std::mutex> lock(bestMoveMutex);
+    return bestMoveFound;
+}
+
+Position SearchContext::getBestMoveSoFar() const {
+    std::lock_guard<std::mutex> lock(bestMoveMutex);
+    return bestMove;
+}
+
+int SearchContext::getBestScoreSoFar() const {
+    std::lock_guard<std::mutex> lock(bestMoveMutex);
+    return bestScore;
+}
+
+void SearchContext::setDeadline(std::chrono::steady_clock::time_point limit) {
+    deadline = limit;
+    hasDeadline = true;
+    deadlinePassed.store(std::chrono::steady_clock::now() >= limit, std::memory_order_relaxed);
+}
+
+void SearchContext::clearDeadline() {
+    hasDeadline = false;
+    deadlinePassed.store(false, std::memory_order_relaxed);
+}
+
+void SearchContext::setBestMove(const Position &move, int score) {
+    std::lock_guard<std::mutex> lock(bestMoveMutex);
+    bestMove = move;
+    bestScore = score;
+    bestMoveFound = true;
+}
+
+void SearchContext::reset() {
+    std::lock_guard<std::mutex> lock(bestMoveMutex);
+    bestMove = Position(-1, -1);
+    bestScore = 0;
+    bestMoveFound = false;
+    nodes.store(0, std::memory_order_relaxed);
+}
+
+SearchHandle &SearchHandle::operator=(SearchHandle &&other) noexcept {
+    if (this != &other) {
+        // same as destroying this handle first
+        stop();
+        if (result.valid())
+            result.wait();
+        context = std::move(other.context);
+        stopSource = std::move(other.stopSource);
+        result = std::move(other.result);
+    }
+    return *this;
+}
+
+SearchHandle::~SearchHandle() {
+    stop();
+    if (result.valid())
+        result.wait();
+}
+
+void SearchHandle::stop() {
+    if (context)
+        stopSource.requestStop();
+}
+
+bool SearchHandle::isReady() const {
+    return !result.valid() || result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+bool SearchHandle::waitFor(std::chrono::milliseconds timeout) const {
+    return !result.valid() || result.wait_for(timeout) == std::future_status::ready;
+}
+
+Position SearchHandle::getBestMoveSoFar() const {
+    return context ? context->getBestMoveSoFar() : Position(-1, -1);
+}
+
+unsigned long long SearchHandle::getNodeCount() const {
+    return context ? context->getNodeCount() : 0;
+}
+
+Position SearchHandle::get() {
+    return result.get();
+}
\ No newline at end of file
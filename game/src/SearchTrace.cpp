@@ -0,0 +1,99 @@
+
+#include "../include/SearchTrace.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+/** Writes a 32-bit value in little-endian order. */
+static void putU32(std::uint32_t value, std::uint8_t *out) {
+    for (int i = 0; i < 4; i++)
+        out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+}
+
+/** Reads a 32-bit little-endian value. */
+static std::uint32_t getU32(const std::uint8_t *in) {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; i++)
+        value |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+    return value;
+}
+
+void SearchTrace::encodeRecord(const Record &record, std::uint8_t *out) {
+    out[0] = record.ply;
+    out[1] = record.depth;
+    out[2] = record.move;
+    out[3] = record.kind;
+    out[4] = record.cutoffIndex;
+    out[5] = record.moveCount;
+    out[6] = record.flags;
+    out[7] = 0;
+    putU32(static_cast<std::uint32_t>(record.alpha), out + 8);
+    putU32(static_cast<std::uint32_t>(record.beta), out + 12);
+    putU32(static_cast<std::uint32_t>(record.score), out + 16);
+    putU32(record.nodes, out + 20);
+}
+
+SearchTrace::Record SearchTrace::decodeRecord(const std::uint8_t *in) {
+    Record record;
+    record.ply = in[0];
+    record.depth = in[1];
+    record.move = in[2];
+    record.kind = static_cast<Kind>(in[3]);
+    record.cutoffIndex = in[4];
+    record.moveCount = in[5];
+    record.flags = in[6];
+    record.alpha = static_cast<std::int32_t>(getU32(in + 8));
+    record.beta = static_cast<std::int32_t>(getU32(in + 12));
+    record.score = static_cast<std::int32_t>(getU32(in + 16));
+    record.nodes = getU32(in + 20);
+    return record;
+}
+
+SearchTrace::SearchTrace(const std::string &path) : out(path, std::ios::binary | std::ios::trunc) {
+    if (!out)
+        throw std::runtime_error("cannot open " + path + " for writing");
+    out.write(MAGIC, sizeof(MAGIC));
+}
+
+SearchTrace::Writer::Writer(SearchTrace &trace, std::size_t capacity)
+    : trace(trace), capacity(std::max<std::size_t>(capacity, 1)), buffer(this->capacity * RECORD_SIZE) {
+    std::lock_guard<std::mutex> lock(trace.mutex);
+    id = trace.nextWriterId++;
+}
+
+void SearchTrace::Writer::flush() {
+    if (count == 0)
+        return;
+    std::uint8_t header[8];
+    putU32(id, header);
+    putU32(static_cast<std::uint32_t>(count), header + 4);
+    std::lock_guard<std::mutex> lock(trace.mutex);
+    trace.out.write(reinterpret_cast<const char *>(header), sizeof(header));
+    trace.out.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(count * RECORD_SIZE));
+    trace.out.flush();
+    count = 0;
+}
+
+void SearchTrace::readMagic(std::istream &in) {
+    char magic[sizeof(MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw std::runtime_error("not a search trace file");
+}
+
+bool SearchTrace::readChunk(std::istream &in, std::uint32_t &writerId, std::vector<Record> &records) {
+    std::uint8_t header[8];
+    if (!in.read(reinterpret_cast<char *>(header), sizeof(header))) {
+        if (in.gcount() == 0)
+            return false;
+        throw std::runtime_error("truncated chunk header");
+    }
+    writerId = getU32(header);
+    std::uint32_t count = getU32(header + 4);
+    std::vector<std::uint8_t> bytes(static_cast<std::size_t>(count) * RECORD_SIZE);
+    if (!in.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+        throw std::runtime_error("truncated chunk");
+    records.resize(count);
+    for (std::uint32_t i = 0; i < count; i++)
+        records[i] = decodeRecord(&bytes[i * RECORD_SIZE]);
+    return true;
+}
\ No newline at end of file
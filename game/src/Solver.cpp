@@ -16,7 +16,11 @@
  */
 
 #include <vector>
+#include <algorithm>
 #include <climits>
+#include "../include/Bitboard.hpp"
+#include "../include/CpuDispatch.hpp"
+#include "../include/Profiler.hpp"
 #include "../include/Solver.hpp"
 
 
@@ -24,60 +28,637 @@ constexpr char EMPTY = '-';
 constexpr char PLAYER_X = 'X';
 constexpr char PLAYER_O = 'O';
 constexpr int BOARD_SIZE = 8;
+constexpr int STORE_MIN_DEPTH = 4; // shallower results are cheaper to search again than to store
+constexpr std::uint64_t STORE_SEARCHER_TO_MOVE = 0x5A17E2C3D4B9F061ULL;
+
+// late move reductions: below LMR_MIN_DEPTH a reduction saves too little to pay for the re-searches
+constexpr int LMR_MIN_DEPTH = 3;
+constexpr int LMR_FULL_DEPTH_MOVES = 3; // the hash move and the best ordered ones are never reduced
+constexpr int LMR_DEEP_DEPTH = 6;       // from there, the moves after LMR_DEEP_MOVES are reduced by 2
+constexpr int LMR_DEEP_MOVES = 6;
+
+/**
+ * Futility margins by remaining depth, in evaluation units: how far a node evaluation can move in
+ * that many plies outside of a corner capture, which is never pruned.
+ */
+constexpr int FUTILITY_MAX_DEPTH = 2;
+constexpr int FUTILITY_MARGIN[FUTILITY_MAX_DEPTH + 1] = {0, 4000, 8000};
+constexpr std::uint64_t CORNERS = 0x8100000000000081ULL;
+
+/**
+ * Move ordering priorities: corners first, then edges and center, and the squares next to the
+ * corners last. Searching likely good moves first produces more alpha-beta cutoffs.
+ */
+constexpr int MOVE_ORDER[BOARD_SIZE * BOARD_SIZE] = {
+        9, 1, 7, 6, 6, 7, 1, 9,
+        1, 0, 3, 3, 3, 3, 0, 1,
+        7, 3, 5, 4, 4, 5, 3, 7,
+        6, 3, 4, 0, 0, 4, 3, 6,
+        6, 3, 4, 0, 0, 4, 3, 6,
+        7, 3, 5, 4, 4, 5, 3, 7,
+        1, 0, 3, 3, 3, 3, 0, 1,
+        9, 1, 7, 6, 6, 7, 1, 9};
+
+/**
+ * Finds the earlier move a move is the image of by a symmetry of the board. Both then lead to the
+ * same position up to that symmetry, so the move needs no search of its own.
+ * @return The index of the earlier move, -1 if there is none.
+ */
+static int symmetricMove(const MoveList &moves, int index, unsigned symmetries, int &symmetry) {
+    if (!symmetries)
+        return -1;
+    const std::uint64_t target = 1ULL << moves[index];
+    for (int earlier = 0; earlier < index; earlier++) {
+        for (int s = 1; s < Bitboard::SYMMETRY_COUNT; s++) {
+            if (((symmetries >> s) & 1) && Bitboard::transform(1ULL << moves[earlier], s) == target) {
+                symmetry = s;
+                return earlier;
+            }
+        }
+    }
+    return -1;
+}
+
+Square Solver::searchSquare(const std::vector<std::vector<char>> &board, char player, int depth) {
+    if (!options.mtdf) {
+        std::vector<MoveAnalysis> best = analyze(board, player, depth, 1);
+        return best.empty() ? NO_SQUARE : toSquare(best.front().move);
+    }
+    // MTD(f) converges in few passes only from a close guess: deepen iteratively, seeding every
+    // iteration with the score of the last one of the same parity
+    context.reset();
+    mtdfPasses.clear();
+    Square best = NO_SQUARE;
+    int scores[2] = {0, 0}; // last scores at odd and even depths, the evaluation depends on the parity
+    for (int iteration = 1; iteration <= depth; iteration++) {
+        std::vector<MoveAnalysis> result = mtdf(board, player, iteration, scores[iteration % 2], best);
+        if (result.empty())
+            break;
+        if (context.stopRequested()) {
+            if (best == NO_SQUARE)
+                best = toSquare(result.front().move);
+            break;
+        }
+        best = toSquare(result.front().move);
+        scores[iteration % 2] = result.front().score;
+    }
+    return best;
+}
+
+std::vector<MoveAnalysis> Solver::analyze(const std::vector<std::vector<char>> &board, char player, int depth,
+                                          int multiPv) {
+    context.reset();
+    mtdfPasses.clear();
+    if (table)
+        table->newSearch();
+    // single working copy, updated in place by make/unmake for the whole search
+    std::vector<std::vector<char>> node = board;
+    setRoot(node, player);
+
+    MoveList moves;
+    generateMoves(player, moves);
+    size_t wanted = (multiPv <= 0 || multiPv > moves.size()) ? moves.size() : multiPv;
+    char o_player = (player == PLAYER_X) ? PLAYER_O : PLAYER_X;
+
+    std::vector<MoveAnalysis> ranking; // by decreasing score, at most wanted moves
+    // results of the searched moves, for the moves equal to them by a symmetry of the root; the
+    // line of a move that was not ranked is empty
+    std::vector<MoveAnalysis> searched(moves.size());
+    const unsigned symmetries = rootSymmetries(node, player);
+    MoveUndo undo;
+    for (int i = 0; i < moves.size(); i++) {
+        Square move = moves[i];
+        // a move must beat the last ranked one to enter a full ranking
+        bool full = ranking.size() == wanted;
+        int alpha = full ? ranking.back().score : INT_MIN;
+        int childScore;
+        bool ranked;
+        std::vector<Position> pv;
+        int symmetry = 0;
+        int earlier = symmetricMove(moves, i, symmetries, symmetry);
+        if (earlier >= 0) {
+            // the same score, and the same line seen through the symmetry
+            childScore = searched[earlier].score;
+            ranked = !searched[earlier].pv.empty() && (!full || childScore > alpha);
+            if (ranked) {
+                for (const Position &position: searched[earlier].pv)
+                    pv.push_back(toPosition(
+                            Bitboard::firstSquare(Bitboard::transform(1ULL << toSquare(position), symmetry))));
+            }
+        } else {
+            makeMove(node, move, player, undo);
+            childScore = miniMaxAlphaBeta(node, player, depth - 1, false, alpha, INT_MAX); // recursive call
+            ranked = !context.stopRequested() && (!full || childScore > alpha);
+            if (ranked) {
+                pv.push_back(toPosition(move));
+                extractPv(node, o_player, depth - 1, pv);
+            }
+            unmakeMove(node, undo, player);
+            if (context.stopRequested())
+                break; // the score of an interrupted child can't be trusted
+            if (symmetries)
+                searched[i] = MoveAnalysis{toPosition(move), childScore, pv};
+        }
+        if (!ranked)
+            continue;
+
+        // insert after the equal scores, so that ties keep board order
+        auto it = ranking.begin();
+        while (it != ranking.end() && it->score >= childScore)
+            ++it;
+        bool newBest = it == ranking.begin();
+        ranking.insert(it, MoveAnalysis{toPosition(move), childScore, std::move(pv)});
+        if (ranking.size() > wanted)
+            ranking.pop_back();
+        if (newBest)
+            context.setBestMove(ranking.front().move, ranking.front().score);
+    }
+    if (trace && !context.stopRequested() && !ranking.empty())
+        traceRoot(depth, ranking.front().score, moves.size(), context.getNodeCount());
+    return ranking;
+}
+
+int Solver::scorePosition(const std::vector<std::vector<char>> &board, char player, int depth) {
+    context.reset();
+    mtdfPasses.clear();
+    if (table)
+        table->newSearch();
+    std::vector<std::vector<char>> node = board;
+    setRoot(node, player);
+    lastMove = NO_SQUARE;
+    return miniMaxAlphaBeta(node, player, depth, true, INT_MIN, INT_MAX);
+}
+
+std::vector<MoveAnalysis> Solver::mtdf(const std::vector<std::vector<char>> &board, char player, int depth,
+                                       int guess, Square firstMove) {
+    if (table)
+        table->newSearch();
+    std::vector<std::vector<char>> node = board;
+    setRoot(node, player);
+    const unsigned long long nodesAtStart = context.getNodeCount();
+
+    MoveList moves;
+    generateMoves(player, moves);
+    if (moves.empty())
+        return {};
+    for (int i = 0; i < moves.size(); i++)
+        moves.score(i) = (moves[i] == firstMove) ? 1 : 0;
+    moves.sortByScore();
+
+    int lower = INT_MIN;
+    int upper = INT_MAX;
+    int score = guess;
+    Square best = NO_SQUARE;
+    const unsigned symmetries = rootSymmetries(node, player);
+    MoveUndo undo;
+    while (lower < upper) {
+        // zero window at the last score, or just above it if it is the lower bound
+        const int beta = (score == lower) ? score + 1 : score;
+        const unsigned long long nodesBefore = context.getNodeCount();
+        int passScore = INT_MIN;
+        Square passBest = NO_SQUARE;
+        for (int i = 0; i < moves.size(); i++) {
+            int symmetry;
+            if (symmetricMove(moves, i, symmetries, symmetry) >= 0)
+                continue; // scores as the earlier move it is the image of
+            makeMove(node, moves[i], player, undo);
+            int childScore = miniMaxAlphaBeta(node, player, depth - 1, false, beta - 1, beta);
+            unmakeMove(node, undo, player);
+            if (context.stopRequested())
+                break;
+            if (childScore > passScore) {
+                passScore = childScore;
+                passBest = moves[i];
+            }
+            if (passScore >= beta)
+                break; // Cutoff
+        }
+        if (context.stopRequested())
+            break; // the score of an interrupted pass can't be trusted
+        score = passScore;
+        mtdfPasses.push_back(MtdfPass{depth, beta, score, context.getNodeCount() - nodesBefore});
+        if (score >= beta) {
+            // only a fail high proves a move reaches the lower bound
+            lower = score;
+            best = passBest;
+            context.setBestMove(toPosition(best), score);
+            for (int i = 0; i < moves.size(); i++)
+                moves.score(i) = (moves[i] == best) ? 1 : 0;
+            moves.sortByScore();
+        } else {
+            upper = score;
+        }
+    }
+    if (best == NO_SQUARE)
+        return {};
+
+    MoveAnalysis analysis{toPosition(best), lower, {toPosition(best)}};
+    if (!context.stopRequested()) {
+        char o_player = (player == PLAYER_X) ? PLAYER_O : PLAYER_X;
+        makeMove(node, best, player, undo);
+        extractPv(node, o_player, depth - 1, analysis.pv);
+        unmakeMove(node, undo, player);
+        if (trace)
+            traceRoot(depth, lower, moves.size(), context.getNodeCount() - nodesAtStart);
+    }
+    return {analysis};
+}
+
+Position Solver::search(const std::vector<std::vector<char>> &board, char player, int depth) {
+    return toPosition(searchSquare(board, player, depth));
+}
+
+Position Solver::searchTimed(const std::vector<std::vector<char>> &board, char player, TimeManager &timeManager,
+                             int maxDepth) {
+    context.setDeadline(timeManager.getHardDeadline());
+    // past the end of the game, deeper iterations search the same tree again
+    int empties = BOARD_SIZE * BOARD_SIZE - BoardHelper::countPiecesTotal(board);
+    maxDepth = std::min(maxDepth, empties + 2);
+    Position best(-1, -1);
+    bool found = false;
+    int scores[2] = {0, 0}; // last scores at odd and even depths, the evaluation depends on the parity
+    mtdfPasses.clear();
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        if (depth > 1 && !timeManager.shouldStartIteration())
+            break;
+        std::vector<MoveAnalysis> ranking;
+        if (options.mtdf) {
+            context.reset();
+            ranking = mtdf(board, player, depth, scores[depth % 2], found ? toSquare(best) : NO_SQUARE);
+        } else {
+            ranking = analyze(board, player, depth, 1);
+        }
+        if (ranking.empty())
+            break;
+        if (context.stopRequested()) {
+            // an aborted iteration has only ranked the moves searched before the abort
+            if (depth == 1) {
+                best = ranking.front().move;
+                found = true;
+            }
+            break;
+        }
+        best = ranking.front().move;
+        found = true;
+        scores[depth % 2] = ranking.front().score;
+        timeManager.iterationDone(ranking.front().score, best);
+    }
+    context.clearDeadline();
+    if (!found) { // aborted before a single move was searched: any legal move beats a loss on time
+        MoveList moves;
+        BoardHelper::getAllPossibleMoves(board, player, moves);
+        if (!moves.empty())
+            best = toPosition(moves[0]);
+    }
+    return best;
+}
+
+Square Solver::getBestMoveSquare(const std::vector<std::vector<char>> &board, char player, int depth) {
+    SearchContext context;
+    return Solver(context).searchSquare(board, player, depth);
+}
 
 Position Solver::getBestMovePosition(const std::vector<std::vector<char>> &board, char player, int depth) {
-    int bestScore = INT_MIN;
-    Position bestMove(-1, -1);
-    for (const Position &move: BoardHelper::getAllPossibleMoves(board, player)) {
-        // create new node
-        std::vector<std::vector<char>> newNode =
-                BoardHelper::getBoardAfterMove(board, move, player);
-        // recursive call
-        int childScore = miniMaxAlphaBeta(newNode, player, depth - 1, false, INT_MIN, INT_MAX);
-        if (childScore > bestScore) {
-            bestScore = childScore;
-            bestMove = move;
+    SearchContext context;
+    return Solver(context).search(board, player, depth);
+}
+
+SearchHandle Solver::startSearch(const std::vector<std::vector<char>> &board, char player, int depth,
+                                 TranspositionTable *table) {
+    StopSource stopSource;
+    auto context = std::make_shared<SearchContext>(stopSource.getToken());
+    std::future<Position> result = std::async(std::launch::async, [context, table, board, player, depth]() {
+        return Solver(*context, table).search(board, player, depth);
+    });
+    return {context, stopSource, std::move(result)};
+}
+
+void Solver::traceRoot(int depth, int score, int moveCount, unsigned long long nodes) {
+    SearchTrace::Record record;
+    record.depth = static_cast<std::uint8_t>(depth);
+    record.kind = SearchTrace::KIND_ROOT;
+    record.moveCount = static_cast<std::uint8_t>(moveCount);
+    record.flags = SearchTrace::FLAG_MAX;
+    record.alpha = INT_MIN;
+    record.beta = INT_MAX;
+    record.score = score;
+    record.nodes = static_cast<std::uint32_t>(std::min<unsigned long long>(nodes, UINT32_MAX));
+    trace->record(record);
+}
+
+void Solver::setRoot(const std::vector<std::vector<char>> &node, char player) {
+    pieceHash = TranspositionTable::hash(node);
+    if (network)
+        network->refresh(accumulator, node);
+    perspective = TranspositionTable::perspectiveKey(player);
+    Bitboard board = Bitboard::fromBoard(node, PLAYER_X);
+    discs[0] = board.player;
+    discs[1] = board.opponent;
+}
+
+unsigned Solver::rootSymmetries(const std::vector<std::vector<char>> &node, char mover) const {
+    // a network is not trained to be symmetric
+    if (network)
+        return 0;
+    return nodeBoard(mover).symmetries();
+}
+
+void Solver::generateMoves(char mover, MoveList &moves) const {
+    PROFILE_SCOPE(MOVE_GENERATION);
+    const int own = mover == PLAYER_X ? 0 : 1;
+    moves.clear();
+    for (std::uint64_t bits = CpuDispatch::kernels().getMoves(discs[own], discs[1 - own]); bits; bits &= bits - 1)
+        moves.push(Bitboard::firstSquare(bits));
+}
+
+bool Solver::isFinished() const {
+    const CpuDispatch::Kernels &kernels = CpuDispatch::kernels();
+    return !kernels.getMoves(discs[0], discs[1]) && !kernels.getMoves(discs[1], discs[0]);
+}
+
+void Solver::makeMove(std::vector<std::vector<char>> &node, Square move, char mover, MoveUndo &undo) {
+    lastMove = move;
+    const int own = mover == PLAYER_X ? 0 : 1;
+    const std::uint64_t flips = CpuDispatch::kernels().getFlips(discs[own], discs[1 - own], move);
+    discs[own] |= flips | (1ULL << move);
+    discs[1 - own] ^= flips;
+    undo.square = move;
+    undo.flipCount = 0;
+    node[move / BOARD_SIZE][move % BOARD_SIZE] = mover;
+    for (std::uint64_t bits = flips; bits; bits &= bits - 1) {
+        Square square = Bitboard::firstSquare(bits);
+        undo.flipped[undo.flipCount++] = square;
+        node[square / BOARD_SIZE][square % BOARD_SIZE] = mover;
+    }
+    if (network)
+        network->applyMove(accumulator, undo, mover);
+    char other = (mover == PLAYER_X) ? PLAYER_O : PLAYER_X;
+    pieceHash ^= TranspositionTable::pieceKey(move, mover);
+    for (int i = 0; i < undo.flipCount; i++)
+        pieceHash ^= TranspositionTable::pieceKey(undo.flipped[i], other) ^
+                     TranspositionTable::pieceKey(undo.flipped[i], mover);
+}
+
+void Solver::unmakeMove(std::vector<std::vector<char>> &node, const MoveUndo &undo, char mover) {
+    char other = (mover == PLAYER_X) ? PLAYER_O : PLAYER_X;
+    pieceHash ^= TranspositionTable::pieceKey(undo.square, mover);
+    for (int i = 0; i < undo.flipCount; i++)
+        pieceHash ^= TranspositionTable::pieceKey(undo.flipped[i], other) ^
+                     TranspositionTable::pieceKey(undo.flipped[i], mover);
+    if (network)
+        network->undoMove(accumulator, undo, mover);
+    BoardHelper::undoMove(node, undo);
+    const int own = mover == PLAYER_X ? 0 : 1;
+    std::uint64_t flips = 0;
+    for (int i = 0; i < undo.flipCount; i++)
+        flips |= 1ULL << undo.flipped[i];
+    discs[own] &= ~(flips | (1ULL << undo.square));
+    discs[1 - own] |= flips;
+}
+
+int Solver::evaluate(const std::vector<std::vector<char>> &node, char player, bool finished) {
+    // the evaluation only depends on the pieces and the point of view
+    const std::uint64_t key = pieceHash ^ perspective;
+    int score;
+    if (evalCache) {
+        evalCacheProbes++;
+        if (evalCache->probe(key, score)) {
+            evalCacheHits++;
+            return score;
         }
     }
-    return bestMove;
+    if (network && !finished) {
+        score = network->evaluate(accumulator, player);
+    } else {
+        // final positions are scored by their discs
+        PROFILE_SCOPE(EVALUATION);
+        Bitboard board = nodeBoard(player);
+        CpuDispatch::kernels().evaluateBatch(&board.player, &board.opponent, &score, 1);
+    }
+    if (evalCache)
+        evalCache->store(key, score);
+    return score;
+}
+
+std::uint64_t Solver::storeKey(const std::vector<std::vector<char>> &node, char mover, bool searcherToMove,
+                              int &symmetry) const {
+    Bitboard board = nodeBoard(mover);
+    std::uint64_t key;
+    if (network) {
+        // a network is not trained to be symmetric, and each network has its own results
+        symmetry = 0;
+        key = board.hash() ^ network->getChecksum();
+    } else {
+        symmetry = board.canonicalSymmetry();
+        key = board.transformed(symmetry).hash();
+    }
+    return searcherToMove ? key ^ STORE_SEARCHER_TO_MOVE : key;
+}
+
+void Solver::extractPv(std::vector<std::vector<char>> &node, char toMove, int maxLength, std::vector<Position> &pv) {
+    if (!table)
+        return;
+    std::vector<std::pair<MoveUndo, char>> played;
+    while ((int) played.size() < maxLength) {
+        std::uint64_t legal = nodeBoard(toMove).getMoves();
+        if (!legal) {
+            toMove = (toMove == PLAYER_X) ? PLAYER_O : PLAYER_X;
+            legal = nodeBoard(toMove).getMoves();
+            if (!legal)
+                break; // game over
+        }
+        const TranspositionTable::Entry *entry = table->probe(pieceHash ^ TranspositionTable::sideKey(toMove) ^ perspective);
+        if (!entry || entry->bestMove == NO_SQUARE || !((legal >> entry->bestMove) & 1))
+            break;
+        pv.push_back(toPosition(entry->bestMove));
+        played.emplace_back(MoveUndo(), toMove);
+        makeMove(node, entry->bestMove, toMove, played.back().first);
+        toMove = (toMove == PLAYER_X) ? PLAYER_O : PLAYER_X;
+    }
+    for (auto it = played.rbegin(); it != played.rend(); ++it)
+        unmakeMove(node, it->first, it->second);
 }
 
 int Solver::miniMaxAlphaBeta(
         std::vector<std::vector<char>> &node, char player, int depth, bool max, int alpha, int beta) {
-    // if terminal reached or depth limit reached evaluate
-    if (depth == 0 || BoardHelper::isGameFinished(node)) {
-        return Evaluator::getEvaluation(node, player);
+    if (!trace)
+        return alphaBetaNode(node, player, depth, max, alpha, beta);
+    const Square move = lastMove;
+    const unsigned long long nodesBefore = context.getNodeCount();
+    tracePly++;
+    int score = alphaBetaNode(node, player, depth, max, alpha, beta);
+    tracePly--;
+    if (context.stopRequested())
+        return score; // an aborted subtree tells nothing
+    SearchTrace::Record record;
+    record.ply = static_cast<std::uint8_t>(tracePly + 1);
+    record.depth = static_cast<std::uint8_t>(depth);
+    record.move = move;
+    record.kind = traceKind;
+    if (traceKind == SearchTrace::KIND_INTERIOR) {
+        record.cutoffIndex = traceCutoff;
+        record.moveCount = traceMoveCount;
     }
+    record.flags = max ? SearchTrace::FLAG_MAX : 0;
+    record.alpha = alpha;
+    record.beta = beta;
+    record.score = score;
+    record.nodes = static_cast<std::uint32_t>(std::min<unsigned long long>(context.getNodeCount() - nodesBefore,
+                                                                           UINT32_MAX));
+    trace->record(record);
+    return score;
+}
+
+int Solver::alphaBetaNode(
+        std::vector<std::vector<char>> &node, char player, int depth, bool max, int alpha, int beta) {
+    PROFILE_SCOPE(SEARCH);
+    context.addNode();
+    if (context.stopRequested())
+        return 0; // discarded by the root
+    // if terminal reached or depth limit reached evaluate; at the depth limit only the network
+    // needs to know whether the game is over
+    const bool finished = (depth > 0 || network) && isFinished();
+    if (depth == 0 || finished) {
+        traceKind = SearchTrace::KIND_LEAF;
+        return evaluate(node, player, finished);
+    }
+    traceKind = SearchTrace::KIND_TABLE; // until the table and the store miss
     char o_player = (player == PLAYER_X) ? PLAYER_O : PLAYER_X;
+    char mover = max ? player : o_player;
+
+    const int alphaOrig = alpha;
+    const int betaOrig = beta;
+    const std::uint64_t key = pieceHash ^ TranspositionTable::sideKey(mover) ^ perspective;
+    Square hashMove = NO_SQUARE;
+    if (table) {
+        if (const TranspositionTable::Entry *entry = table->probe(key)) {
+            hashMove = entry->bestMove;
+            if (entry->depth >= depth) {
+                if (entry->bound == TranspositionTable::BOUND_EXACT)
+                    return entry->score;
+                if (entry->bound == TranspositionTable::BOUND_LOWER && entry->score > alpha)
+                    alpha = entry->score;
+                if (entry->bound == TranspositionTable::BOUND_UPPER && entry->score < beta)
+                    beta = entry->score;
+                if (beta <= alpha)
+                    return entry->score;
+            }
+        }
+    }
+
+    // second level: results of earlier runs or other processes, for the deep nodes the table missed
+    std::uint64_t storedKey = 0;
+    int symmetry = 0;
+    if (store && depth >= STORE_MIN_DEPTH) {
+        storedKey = storeKey(node, mover, max, symmetry);
+        AnalysisStore::Entry entry;
+        if (store->probe(storedKey, entry)) {
+            Square move = entry.bestMove == NO_SQUARE ? NO_SQUARE
+                          : Bitboard::firstSquare(Bitboard::transform(1ULL << entry.bestMove,
+                                                                      Bitboard::inverseSymmetry(symmetry)));
+            if (hashMove == NO_SQUARE)
+                hashMove = move;
+            if (entry.depth >= depth) {
+                if (table)
+                    table->store(key, entry.depth, entry.score, entry.bound, move);
+                if (entry.bound == TranspositionTable::BOUND_EXACT)
+                    return entry.score;
+                if (entry.bound == TranspositionTable::BOUND_LOWER && entry.score > alpha)
+                    alpha = entry.score;
+                if (entry.bound == TranspositionTable::BOUND_UPPER && entry.score < beta)
+                    beta = entry.score;
+                if (beta <= alpha)
+                    return entry.score;
+            }
+        }
+    }
 
-    const auto &moves = max ? BoardHelper::getAllPossibleMoves(node, player)
-                            : BoardHelper::getAllPossibleMoves(node, o_player);
+    MoveList moves;
+    generateMoves(mover, moves);
     if (moves.empty()) { // if no moves available then forfeit turn
-        return miniMaxAlphaBeta(node, player, depth - 1, !max, alpha, beta);
+        lastMove = NO_SQUARE;
+        int score = miniMaxAlphaBeta(node, player, depth - 1, !max, alpha, beta);
+        traceKind = SearchTrace::KIND_PASS;
+        return score;
     }
 
+    // futility pruning: near the leaves, a node evaluated far outside the window is cut unless
+    // the mover can take a corner, the one move that swings the evaluation by more than the margin
+    if (options.futilityPruning && depth <= FUTILITY_MAX_DEPTH) {
+        bool cornerMove = false;
+        for (Square move: moves)
+            cornerMove |= ((CORNERS >> move) & 1) != 0;
+        if (!cornerMove) {
+            traceKind = SearchTrace::KIND_FUTILITY;
+            int staticScore = evaluate(node, player, false);
+            if (max && staticScore + FUTILITY_MARGIN[depth] <= alpha)
+                return staticScore + FUTILITY_MARGIN[depth];
+            if (!max && staticScore - FUTILITY_MARGIN[depth] >= beta)
+                return staticScore - FUTILITY_MARGIN[depth];
+        }
+    }
+    for (int i = 0; i < moves.size(); i++)
+        moves.score(i) = (moves[i] == hashMove) ? INT_MAX : MOVE_ORDER[moves[i]];
+    moves.sortByScore();
+
     int score = max ? INT_MIN : INT_MAX;
-    for (const Position &move: moves) {
-        // create new node
-        std::vector<std::vector<char>> newNode =
-                BoardHelper::getBoardAfterMove(node, move, max ? player : o_player);
+    Square bestMove = NO_SQUARE;
+    std::uint8_t cutoff = SearchTrace::NO_CUTOFF;
+    MoveUndo undo;
+    for (int i = 0; i < moves.size(); i++) {
+        Square move = moves[i];
+        int reduction = 0;
+        if (options.lateMoveReductions && depth >= LMR_MIN_DEPTH && i >= LMR_FULL_DEPTH_MOVES &&
+            moves.score(i) != INT_MAX)
+            reduction = (depth >= LMR_DEEP_DEPTH && i >= LMR_DEEP_MOVES) ? 2 : 1;
+        makeMove(node, move, mover, undo);
         int childScore =
-                miniMaxAlphaBeta(newNode, player, depth - 1, !max, alpha, beta); // recursive call
+                miniMaxAlphaBeta(node, player, depth - 1 - reduction, !max, alpha, beta); // recursive call
+        // a reduced move that would improve the node is searched again at full depth
+        if (reduction > 0 && (max ? childScore > alpha : childScore < beta))
+            childScore = miniMaxAlphaBeta(node, player, depth - 1, !max, alpha, beta);
+        unmakeMove(node, undo, mover);
 
         if (max) { // maximizing
-            if (childScore > score)
+            if (childScore > score) {
                 score = childScore;
+                bestMove = move;
+            }
             if (score > alpha)
                 alpha = score; // update alpha
         } else {               // minimizing
-            if (childScore < score)
+            if (childScore < score) {
                 score = childScore;
+                bestMove = move;
+            }
             if (score < beta)
                 beta = score; // update beta
         }
 
-        if (beta <= alpha)
+        if (beta <= alpha) {
+            cutoff = static_cast<std::uint8_t>(i);
             break; // Cutoff
+        }
+        if (context.stopRequested())
+            break;
+    }
+    traceKind = SearchTrace::KIND_INTERIOR;
+    traceCutoff = cutoff;
+    traceMoveCount = static_cast<std::uint8_t>(moves.size());
+
+    if (table && !context.stopRequested()) {
+        TranspositionTable::Bound bound = score <= alphaOrig  ? TranspositionTable::BOUND_UPPER
+                                          : score >= betaOrig ? TranspositionTable::BOUND_LOWER
+                                                              : TranspositionTable::BOUND_EXACT;
+        table->store(key, depth, score, bound, bestMove);
+    }
+    if (store && depth >= STORE_MIN_DEPTH && !context.stopRequested()) {
+        TranspositionTable::Bound bound = score <= alphaOrig  ? TranspositionTable::BOUND_UPPER
+                                          : score >= betaOrig ? TranspositionTable::BOUND_LOWER
+                                                              : TranspositionTable::BOUND_EXACT;
+        Square storedMove = bestMove == NO_SQUARE ? NO_SQUARE
+                            : Bitboard::firstSquare(Bitboard::transform(1ULL << bestMove, symmetry));
+        store->store(storedKey, {score, depth, bound, storedMove});
     }
     return score;
 }
\ No newline at end of file
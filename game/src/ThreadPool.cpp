@@ -0,0 +1,133 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/ThreadPool.hpp"
+#include <algorithm>
+
+/** Pool the calling thread works for, and the index of its queue in that pool. */
+static thread_local const ThreadPool *currentPool = nullptr;
+static thread_local std::size_t currentQueue = 0;
+
+/** Failed attempts to find a task before a waiting thread sleeps: the group often ends just after. */
+constexpr int WAIT_SPINS = 64;
+
+ThreadPool::ThreadPool(unsigned int threadCount) {
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0; i <= threadCount; i++)
+        queues.push_back(std::make_unique<Queue>());
+    for (unsigned int i = 0; i < threadCount; i++)
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    sleepCondition.notify_all();
+    for (std::thread &worker: workers)
+        worker.join();
+}
+
+std::size_t ThreadPool::ownQueue() const {
+    return currentPool == this ? currentQueue : queues.size() - 1;
+}
+
+void ThreadPool::submit(TaskGroup &group, std::function<void()> task) {
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+    Queue &queue = *queues[ownQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(Task{std::move(task), &group});
+    }
+    queuedTasks.fetch_add(1, std::memory_order_release);
+    {
+        // taking the lock orders this notification after a worker's check of queuedTasks
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    sleepCondition.notify_one();
+}
+
+bool ThreadPool::runOne(std::size_t self) {
+    if (queuedTasks.load(std::memory_order_acquire) == 0)
+        return false;
+    Task task;
+    bool found = false;
+    for (std::size_t i = 0; i < queues.size() && !found; i++) {
+        std::size_t index = (self + i) % queues.size();
+        Queue &queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            continue;
+        if (index == self) { // own queue: newest first
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {             // steal: oldest first
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        found = true;
+    }
+    if (!found)
+        return false;
+    queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+    task.function();
+    // the group must not be touched once pending is 0: its waiter may have returned and destroyed it
+    if (task.group->pending.fetch_sub(1) == 1 && sleepingWaiters.load() > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        sleepCondition.notify_all();
+    }
+    return true;
+}
+
+void ThreadPool::wait(TaskGroup &group) {
+    std::size_t self = ownQueue();
+    int spins = 0;
+    while (!group.isDone()) {
+        if (runOne(self)) {
+            spins = 0;
+        } else if (spins < WAIT_SPINS) {
+            spins++;
+            std::this_thread::yield(); // the remaining tasks of the group are running elsewhere
+        } else {
+            // sleep until the last task of the group ends, or a task is queued to help with
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepingWaiters++;
+            sleepCondition.wait(lock, [this, &group]() {
+                return group.pending.load() == 0 || queuedTasks.load(std::memory_order_acquire) > 0;
+            });
+            sleepingWaiters--;
+            spins = 0;
+        }
+    }
+}
+
+void ThreadPool::workerLoop(std::size_t self) {
+    currentPool = this;
+    currentQueue = self;
+    while (true) {
+        if (runOne(self))
+            continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [this]() {
+            return stopping || queuedTasks.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping && queuedTasks.load(std::memory_order_acquire) == 0)
+            return;
+    }
+}
\ No newline at end of file
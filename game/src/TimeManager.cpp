@@ -0,0 +1,76 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/TimeManager.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+constexpr std::chrono::milliseconds MIN_RESERVE(30); // kept on the clock for the overhead around the search
+constexpr int RESERVE_DIVISOR = 20;                  // or a twentieth of the clock, if more
+constexpr int HARD_LIMIT_FACTOR = 4;                 // hard limit, in soft budgets
+constexpr double INCREMENT_SHARE = 0.75;             // share of the increment spent on the move
+constexpr double BEST_MOVE_CHANGE_FACTOR = 1.6;
+constexpr double SCORE_SWING_FACTOR = 1.3;
+constexpr int SCORE_SWING = 500;                     // in Evaluator units
+constexpr double STABLE_FACTOR = 0.85;
+constexpr double MIN_INSTABILITY = 0.6;
+constexpr double MAX_INSTABILITY = 2.5;
+constexpr double NEXT_ITERATION_SHARE = 0.5; // an iteration costs about as much as all the previous ones
+
+TimeManager::TimeManager(const TimeControl &control) : control(control), remaining(control.total) {}
+
+void TimeManager::startMove(int empties) {
+    start = std::chrono::steady_clock::now();
+    instability = 1.0;
+    iterations = 0;
+
+    std::chrono::milliseconds reserve = std::max(MIN_RESERVE, remaining / RESERVE_DIVISOR);
+    std::chrono::milliseconds usable = std::max(std::chrono::milliseconds(1), remaining - reserve);
+    int movesLeft = std::max(1, (empties + 1) / 2);
+    softBudget = usable / movesLeft +
+                 std::chrono::milliseconds(static_cast<long long>(control.increment.count() * INCREMENT_SHARE));
+    softBudget = std::min(softBudget, usable);
+    hardLimit = std::min(usable, softBudget * HARD_LIMIT_FACTOR);
+}
+
+void TimeManager::stopMove() {
+    remaining -= getElapsed();
+    remaining += control.increment;
+}
+
+bool TimeManager::shouldStartIteration() const {
+    return getElapsed().count() < softBudget.count() * instability * NEXT_ITERATION_SHARE;
+}
+
+void TimeManager::iterationDone(int score, const Position &bestMove) {
+    if (iterations > 0) {
+        if (!(bestMove == lastBestMove))
+            instability *= BEST_MOVE_CHANGE_FACTOR;
+        else
+            instability *= STABLE_FACTOR;
+        if (std::abs(score - lastScore) > SCORE_SWING)
+            instability *= SCORE_SWING_FACTOR;
+        instability = std::clamp(instability, MIN_INSTABILITY, MAX_INSTABILITY);
+    }
+    iterations++;
+    lastScore = score;
+    lastBestMove = bestMove;
+}
+
+std::chrono::milliseconds TimeManager::getElapsed() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+}
\ No newline at end of file
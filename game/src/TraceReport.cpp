@@ -0,0 +1,144 @@
+
+#include "../include/TraceReport.hpp"
+#include "../include/SearchTrace.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <vector>
+
+constexpr int BOARD_SIZE = 8;
+constexpr int MAX_DEPTH = 256;     // the depth of a record is one byte
+constexpr int CUTOFF_COLUMNS = 4; // first, second, third, later
+
+/** A subtree near the root, ranked by its node count. */
+struct Subtree {
+    std::vector<Square> path; // moves from the root, filled as the ancestors are read
+    SearchTrace::Record record;
+    std::uint32_t writerId;
+    unsigned long long search; // number of the root search of the writer, from 1
+};
+
+/** Subtrees of one writer still waiting for their ancestors. */
+struct WriterState {
+    /** Root searches completed so far. */
+    unsigned long long searches = 0;
+    /** Subtrees waiting for their ancestor at each ply. */
+    std::vector<Subtree> waiting[TraceReport::MAX_RANKED_PLY + 1];
+};
+
+/** Returns the name of a move, e.g. "d3", or "pass". */
+static std::string moveName(Square move) {
+    if (move == NO_SQUARE)
+        return "pass";
+    return {static_cast<char>('a' + move % BOARD_SIZE), static_cast<char>('1' + move / BOARD_SIZE)};
+}
+
+/** Returns a percentage, 0 if the total is 0. */
+static double percent(unsigned long long count, unsigned long long total) {
+    return total > 0 ? 100.0 * static_cast<double>(count) / static_cast<double>(total) : 0.0;
+}
+
+void TraceReport::run(std::istream &in, std::ostream &out, int top) {
+    unsigned long long records = 0;
+    unsigned long long kinds[SearchTrace::KIND_ROOT + 1] = {};
+    unsigned long long rootNodes = 0;
+    unsigned long long interior[MAX_DEPTH] = {};
+    unsigned long long cutoffs[MAX_DEPTH][CUTOFF_COLUMNS] = {};
+    unsigned long long cutoffIndexSum[MAX_DEPTH] = {};
+    std::map<std::uint32_t, WriterState> writers;
+    std::vector<Subtree> ranked;
+    auto keepTop = [&ranked, top]() {
+        auto byNodes = [](const Subtree &a, const Subtree &b) { return a.record.nodes > b.record.nodes; };
+        std::size_t kept = std::min(ranked.size(), static_cast<std::size_t>(std::max(top, 0)));
+        std::partial_sort(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(kept), ranked.end(), byNodes);
+        ranked.resize(kept);
+    };
+
+    SearchTrace::read(in, [&](std::uint32_t writerId, const std::vector<SearchTrace::Record> &chunk) {
+        WriterState &state = writers[writerId];
+        for (const SearchTrace::Record &record: chunk) {
+            records++;
+            if (record.kind <= SearchTrace::KIND_ROOT)
+                kinds[record.kind]++;
+            if (record.kind == SearchTrace::KIND_ROOT) {
+                rootNodes += record.nodes;
+                state.searches++;
+                for (std::vector<Subtree> &waiting: state.waiting)
+                    waiting.clear(); // left by an aborted search
+                continue;
+            }
+            if (record.kind == SearchTrace::KIND_INTERIOR) {
+                interior[record.depth]++;
+                if (record.cutoffIndex != SearchTrace::NO_CUTOFF) {
+                    cutoffs[record.depth][std::min<int>(record.cutoffIndex, CUTOFF_COLUMNS - 1)]++;
+                    cutoffIndexSum[record.depth] += record.cutoffIndex;
+                }
+            }
+            if (record.ply == 0 || record.ply > MAX_RANKED_PLY)
+                continue;
+
+            // this node is the parent of the subtrees waiting at its ply: prepend its move
+            std::vector<Subtree> &waiting = state.waiting[record.ply];
+            waiting.push_back(Subtree{{}, record, writerId, state.searches + 1});
+            for (Subtree &subtree: waiting) {
+                subtree.path.push_back(record.move); // reversed once complete
+                if (record.ply == 1) {
+                    std::reverse(subtree.path.begin(), subtree.path.end());
+                    ranked.push_back(std::move(subtree));
+                } else {
+                    state.waiting[record.ply - 1].push_back(std::move(subtree));
+                }
+            }
+            waiting.clear();
+            if (ranked.size() > 4 * static_cast<std::size_t>(std::max(top, 1)))
+                keepTop();
+        }
+    });
+    keepTop();
+
+    unsigned long long visited = 0;
+    for (int kind = SearchTrace::KIND_INTERIOR; kind < SearchTrace::KIND_ROOT; kind++)
+        visited += kinds[kind];
+    out << "records   : " << records << std::endl;
+    out << "searches  : " << kinds[SearchTrace::KIND_ROOT] << " (" << rootNodes << " nodes)" << std::endl;
+    out << "nodes     : " << visited << std::endl;
+    out << std::fixed << std::setprecision(1);
+    out << "  interior: " << std::setw(12) << kinds[SearchTrace::KIND_INTERIOR] << std::setw(7)
+        << percent(kinds[SearchTrace::KIND_INTERIOR], visited) << " %" << std::endl;
+    out << "  leaf    : " << std::setw(12) << kinds[SearchTrace::KIND_LEAF] << std::setw(7)
+        << percent(kinds[SearchTrace::KIND_LEAF], visited) << " %" << std::endl;
+    out << "  table   : " << std::setw(12) << kinds[SearchTrace::KIND_TABLE] << std::setw(7)
+        << percent(kinds[SearchTrace::KIND_TABLE], visited) << " %" << std::endl;
+    out << "  pass    : " << std::setw(12) << kinds[SearchTrace::KIND_PASS] << std::setw(7)
+        << percent(kinds[SearchTrace::KIND_PASS], visited) << " %" << std::endl;
+    out << "  futility: " << std::setw(12) << kinds[SearchTrace::KIND_FUTILITY] << std::setw(7)
+        << percent(kinds[SearchTrace::KIND_FUTILITY], visited) << " %" << std::endl;
+
+    out << std::endl << "cutoff move index by remaining depth (% of the cutoffs)" << std::endl;
+    out << "depth    interior   cut %    1st %    2nd %    3rd %   4th+ %  mean index" << std::endl;
+    for (int depth = 0; depth < MAX_DEPTH; depth++) {
+        if (interior[depth] == 0)
+            continue;
+        unsigned long long cut = 0;
+        for (unsigned long long count: cutoffs[depth])
+            cut += count;
+        out << std::setw(5) << depth << std::setw(12) << interior[depth] << std::setw(8) << percent(cut, interior[depth]);
+        for (unsigned long long count: cutoffs[depth])
+            out << std::setw(9) << percent(count, cut);
+        out << std::setw(12) << std::setprecision(2)
+            << (cut > 0 ? static_cast<double>(cutoffIndexSum[depth]) / static_cast<double>(cut) : 0.0)
+            << std::setprecision(1) << std::endl;
+    }
+    out << std::defaultfloat;
+
+    out << std::endl << "most expensive subtrees (ply 1 to " << MAX_RANKED_PLY << ")" << std::endl;
+    out << "  writer  search       nodes  ply  depth  path" << std::endl;
+    for (const Subtree &subtree: ranked) {
+        out << std::setw(8) << subtree.writerId << std::setw(8) << subtree.search << std::setw(12) << subtree.record.nodes << std::setw(5) << static_cast<int>(subtree.record.ply)
+            << std::setw(7) << static_cast<int>(subtree.record.depth) << " ";
+        for (Square move: subtree.path)
+            out << " " << moveName(move);
+        out << std::endl;
+    }
+}
\ No newline at end of file
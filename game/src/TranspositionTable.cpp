@@ -0,0 +1,63 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../include/TranspositionTable.hpp"
+#include <algorithm>
+
+constexpr char EMPTY = '-';
+constexpr int BOARD_SIZE = 8;
+
+TranspositionTable::TranspositionTable(std::size_t sizeInMegabytes) {
+    std::size_t count = 1;
+    while (count * 2 * sizeof(Entry) <= sizeInMegabytes * 1024 * 1024)
+        count *= 2;
+    entries.resize(count);
+}
+
+const TranspositionTable::Entry *TranspositionTable::probe(std::uint64_t key) const {
+    const Entry &entry = entries[key & (entries.size() - 1)];
+    if (entry.bound == BOUND_NONE || entry.key != key)
+        return nullptr;
+    return &entry;
+}
+
+void TranspositionTable::store(std::uint64_t key, int depth, int score, Bound bound, Square bestMove) {
+    Entry &entry = entries[key & (entries.size() - 1)];
+    if (entry.bound != BOUND_NONE && entry.generation == generation && entry.key != key && entry.depth > depth)
+        return; // keep the deeper result of this search
+    if (entry.key == key && bestMove == NO_SQUARE)
+        bestMove = entry.bestMove; // keep the known best move for ordering
+    entry.key = key;
+    entry.score = score;
+    entry.depth = static_cast<std::int8_t>(depth);
+    entry.bound = bound;
+    entry.bestMove = bestMove;
+    entry.generation = generation;
+}
+
+void TranspositionTable::clear() {
+    std::fill(entries.begin(), entries.end(), Entry());
+}
+
+std::uint64_t TranspositionTable::hash(const std::vector<std::vector<char>> &board) {
+    std::uint64_t h = 0;
+    for (int row = 0; row < BOARD_SIZE; row++)
+        for (int col = 0; col < BOARD_SIZE; col++)
+            if (board[row][col] != EMPTY)
+                h ^= pieceKey(static_cast<Square>(row * BOARD_SIZE + col), board[row][col]);
+    return h;
+}
\ No newline at end of file
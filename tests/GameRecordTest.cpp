@@ -0,0 +1,89 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../game/include/GameRecord.hpp"
+#include <filesystem>
+#include <iostream>
+
+/**
+ * Appends games to a record file, cuts the last one as a crash while writing would, reopens the
+ * file, appends again and checks that every complete game reads back, through a matching index.
+ */
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+static std::vector<Square> makeGame(int length, int seed) {
+    std::vector<Square> moves;
+    for (int i = 0; i < length; i++)
+        moves.push_back(static_cast<Square>((seed * 7 + i * 3) % 64));
+    return moves;
+}
+
+static void checkGames(const std::string &path, const std::vector<std::vector<Square>> &games, const std::string &step) {
+    GameRecord::Reader reader(path);
+    check(reader.size() == games.size(), step + ": game count");
+    for (std::size_t i = 0; i < games.size() && i < reader.size(); i++) {
+        GameRecord::GameView view = reader.game(i);
+        std::vector<Square> moves(view.moves, view.moves + view.header.moveCount);
+        check(moves == games[i], step + ": moves of game " + std::to_string(i + 1));
+        check(view.header.result == static_cast<int>(i), step + ": result of game " + std::to_string(i + 1));
+    }
+    check(std::filesystem::file_size(path + ".idx") == 8 * games.size(), step + ": index entries");
+}
+
+static void cutAndReopen(const std::string &path, std::uintmax_t cutBytes, const std::string &step) {
+    std::vector<std::vector<Square>> kept;
+    {
+        GameRecord::Writer writer(path);
+        for (int i = 0; i < 3; i++) {
+            kept.push_back(makeGame(20 + i, i));
+            writer.append(kept.back(), i);
+        }
+    }
+    // the last game loses its tail, its index entry stays
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - cutBytes);
+    kept.pop_back();
+    {
+        GameRecord::Writer writer(path);
+        for (int i = 2; i < 4; i++) {
+            kept.push_back(makeGame(30 + i, i));
+            writer.append(kept.back(), i);
+        }
+    }
+    checkGames(path, kept, step);
+}
+
+int main() {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "othello_game_record_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    cutAndReopen((directory / "moves.rec").string(), 5, "cut in the moves");
+    cutAndReopen((directory / "header.rec").string(), 22 + 3, "cut in the header");
+
+    std::filesystem::remove_all(directory);
+    if (failures == 0)
+        std::cout << "GameRecordTest passed" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
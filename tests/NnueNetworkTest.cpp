@@ -0,0 +1,102 @@
+/*
+ * Othello - C++
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "../game/include/CpuDispatch.hpp"
+#include "../game/include/NnueNetwork.hpp"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <random>
+
+/**
+ * Plays random games with a network of random weights, with every kernel variant the CPU runs,
+ * and checks that the accumulator updated move by move always equals the one computed from
+ * scratch, and that taking the moves back returns to the accumulator of the start.
+ */
+
+static int failures = 0;
+
+static void check(bool condition, const std::string &what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+static bool sameAccumulator(const NnueNetwork::Accumulator &a, const NnueNetwork::Accumulator &b) {
+    return std::memcmp(a.values, b.values, sizeof(a.values)) == 0;
+}
+
+static void playRandomGame(const NnueNetwork &network, std::mt19937 &random, const std::string &step) {
+    std::vector<std::vector<char>> board(8, std::vector<char>(8));
+    BoardHelper::initBoard(board);
+    NnueNetwork::Accumulator start, accumulator, refreshed;
+    network.refresh(start, board);
+    accumulator = start;
+
+    struct Played {
+        MoveUndo undo;
+        char mover;
+    };
+    std::vector<Played> played;
+    char player = 'X';
+    MoveList moves;
+    while (!BoardHelper::isGameFinished(board)) {
+        BoardHelper::getAllPossibleMoves(board, player, moves);
+        if (moves.empty()) {
+            player = player == 'X' ? 'O' : 'X';
+            continue;
+        }
+        Played move{MoveUndo(), player};
+        BoardHelper::playMove(board, moves[static_cast<int>(random() % moves.size())], player, move.undo);
+        network.applyMove(accumulator, move.undo, player);
+        played.push_back(move);
+
+        std::string where = step + ", ply " + std::to_string(played.size());
+        network.refresh(refreshed, board);
+        check(sameAccumulator(accumulator, refreshed), where + ": incremental accumulator");
+        check(network.evaluate(accumulator, 'X') == network.evaluate(board, 'X'), where + ": evaluation of X");
+        check(network.evaluate(accumulator, 'O') == network.evaluate(board, 'O'), where + ": evaluation of O");
+        player = player == 'X' ? 'O' : 'X';
+    }
+    for (auto it = played.rbegin(); it != played.rend(); ++it) {
+        network.undoMove(accumulator, it->undo, it->mover);
+        BoardHelper::undoMove(board, it->undo);
+    }
+    check(sameAccumulator(accumulator, start), step + ": accumulator after taking every move back");
+}
+
+int main() {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "othello_nnue_test.nnue";
+    NnueNetwork::writeRandom(path.string(), 7);
+    NnueNetwork network(path.string());
+    std::filesystem::remove(path);
+
+    const CpuDispatch::Isa best = CpuDispatch::detect();
+    for (int isa = CpuDispatch::ISA_BASELINE; isa <= best; isa++) {
+        const CpuDispatch::Kernels &kernels = CpuDispatch::select(static_cast<CpuDispatch::Isa>(isa));
+        if (kernels.isa != isa)
+            continue; // not built
+        std::mt19937 random(isa + 1);
+        for (int game = 0; game < 20; game++)
+            playRandomGame(network, random, std::string(kernels.name) + " game " + std::to_string(game + 1));
+    }
+
+    if (failures == 0)
+        std::cout << "NnueNetworkTest passed" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file